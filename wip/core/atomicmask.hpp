@@ -0,0 +1,94 @@
+#ifndef CORE_ATOMICMASK_HPP
+#define CORE_ATOMICMASK_HPP
+
+#include "../global/bit.hpp"
+#include <atomic>
+
+namespace core {
+
+/**
+ * @brief bit mask claimed by many threads, slot set by fetch_or, summary word of full words for search
+ * @note  claim and vacate are lock-free, others are plain relaxed access for single thread use,
+ *        summary is a hint, a word marked full but freed is found by the fallback scan and unmarked
+ *
+ * @tparam N bit count
+ */
+template<size_t N> class AtomicMask {
+public:
+    static constexpr size_t WORDS = (N + 63) / 64;     //!< flag words
+    static constexpr size_t TOPS  = (WORDS + 63) / 64; //!< summary words
+
+public:
+    /**
+     * @brief set a free bit on, lowest word first by summary
+     * @return index, -1 if all on
+     */
+    size_t claim() noexcept;
+
+public:
+    /**
+     * @brief set a bit off
+     *
+     * @param [in] idx index
+     * @return false if already off, e.g. double free
+     */
+    bool vacate(size_t idx) noexcept;
+
+public:
+    /**
+     * @param  [in] idx index
+     * @return this
+     */
+    AtomicMask<N>& on(size_t idx) noexcept;
+
+public:
+    /**
+     * @param  [in] idx index
+     * @return this
+     */
+    AtomicMask<N>& off(size_t idx) noexcept;
+
+public:
+    /**
+     * @param  [in] idx index
+     * @return get flag state
+     */
+    bool check(size_t idx) const noexcept;
+
+public:
+    /**
+     * @return first off index, -1 is not found
+     */
+    size_t next() const noexcept;
+
+public:
+    /**
+     * @param  [in] idx word index, 0 ~ WORDS - 1
+     * @return 64 flags of word, bit i is index idx * 64 + i
+     */
+    uint64_t word(size_t idx) const noexcept;
+
+public:
+    /**
+     * @brief set all flags off
+     * @return this
+     */
+    AtomicMask<N>& clear() noexcept;
+
+private:
+    //! @brief valid bits of word, bits over N are never claimed
+    static constexpr uint64_t valid(size_t idx) noexcept;
+
+private:
+    //! @brief claim in word, return bit index in word or -1 if full
+    size_t take(size_t idx) noexcept;
+
+private:
+    std::atomic<uint64_t> flags[WORDS]; //!< bit-mask flags
+    std::atomic<uint64_t> tops[TOPS];   //!< bit i: flags[i] may be full
+};
+
+} // namespace core
+
+#include "atomicmask.ipp"
+#endif
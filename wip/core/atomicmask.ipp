@@ -0,0 +1,115 @@
+#ifndef CORE_ATOMICMASK_HPP
+#    include "atomicmask.hpp"
+#endif
+
+namespace core {
+
+template<size_t N> size_t AtomicMask<N>::claim() noexcept {
+    // first: words not marked full
+    for(size_t t = 0; t < TOPS; ++t) {
+        const uint64_t live = t == TOPS - 1 && WORDS % 64 ? (uint64_t(1) << (WORDS % 64)) - 1 : ~uint64_t(0);
+        for(uint64_t open = ~tops[t].load(std::memory_order_relaxed) & live; open; open &= open - 1) {
+            const size_t idx = (t << 6) + size_t(global::bit_ctz(open));
+            const size_t bit = take(idx);
+            if(bit != size_t(-1)) {
+                return (idx << 6) + bit;
+            }
+        }
+    }
+
+    // second: stale summary, freed after marked
+    for(size_t idx = 0; idx < WORDS; ++idx) {
+        if(flags[idx].load(std::memory_order_relaxed) != valid(idx)) {
+            tops[idx >> 6].fetch_and(~(uint64_t(1) << (idx & 63)), std::memory_order_relaxed);
+            const size_t bit = take(idx);
+            if(bit != size_t(-1)) {
+                return (idx << 6) + bit;
+            }
+        }
+    }
+    return size_t(-1);
+}
+
+template<size_t N> bool AtomicMask<N>::vacate(size_t index) noexcept {
+    const uint64_t bit = uint64_t(1) << (index & 63);
+    const uint64_t old = flags[index >> 6].fetch_and(~bit, std::memory_order_release);
+    if(!(old & bit)) {
+        return false;
+    }
+    if(old == valid(index >> 6)) {
+        tops[index >> 12].fetch_and(~(uint64_t(1) << ((index >> 6) & 63)), std::memory_order_relaxed); // not full
+    }
+    return true;
+}
+
+template<size_t N> AtomicMask<N>& AtomicMask<N>::on(size_t index) noexcept {
+    std::atomic<uint64_t>& flag = flags[index >> 6];
+    flag.store(flag.load(std::memory_order_relaxed) | (uint64_t(1) << (index & 63)), std::memory_order_relaxed);
+    return *this;
+}
+
+template<size_t N> AtomicMask<N>& AtomicMask<N>::off(size_t index) noexcept {
+    std::atomic<uint64_t>& flag = flags[index >> 6];
+    flag.store(flag.load(std::memory_order_relaxed) & ~(uint64_t(1) << (index & 63)), std::memory_order_relaxed);
+    tops[index >> 12].store(tops[index >> 12].load(std::memory_order_relaxed) & ~(uint64_t(1) << ((index >> 6) & 63)),
+                            std::memory_order_relaxed);
+    return *this;
+}
+
+template<size_t N> bool AtomicMask<N>::check(size_t index) const noexcept {
+    return (flags[index >> 6].load(std::memory_order_relaxed) >> (index & 63)) & 1;
+}
+
+template<size_t N> size_t AtomicMask<N>::next() const noexcept {
+    for(size_t i = 0; i < WORDS; ++i) {
+        const uint64_t open = ~flags[i].load(std::memory_order_relaxed) & valid(i);
+        if(open) {
+            return (i << 6) + size_t(global::bit_ctz(open));
+        }
+    }
+    return size_t(-1); // not found
+}
+
+template<size_t N> uint64_t AtomicMask<N>::word(size_t index) const noexcept {
+    return flags[index].load(std::memory_order_relaxed);
+}
+
+template<size_t N> AtomicMask<N>& AtomicMask<N>::clear() noexcept {
+    for(size_t i = 0; i < WORDS; ++i) {
+        flags[i].store(0, std::memory_order_relaxed);
+    }
+    for(size_t i = 0; i < TOPS; ++i) {
+        tops[i].store(0, std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+template<size_t N> constexpr uint64_t AtomicMask<N>::valid(size_t index) noexcept {
+    return index == WORDS - 1 && N % 64 ? (uint64_t(1) << (N % 64)) - 1 : ~uint64_t(0);
+}
+
+template<size_t N> size_t AtomicMask<N>::take(size_t index) noexcept {
+    std::atomic<uint64_t>& flag = flags[index];
+
+    uint64_t bits = flag.load(std::memory_order_relaxed);
+    while(true) {
+        const uint64_t open = ~bits & valid(index);
+        if(!open) {
+            tops[index >> 6].fetch_or(uint64_t(1) << (index & 63), std::memory_order_relaxed); // hint: full
+            return size_t(-1);
+        }
+
+        // lowest free bit, lost if other thread set it first
+        const uint64_t bit = open & (~open + 1);
+        const uint64_t old = flag.fetch_or(bit, std::memory_order_acquire);
+        if(!(old & bit)) {
+            if((old | bit) == valid(index)) {
+                tops[index >> 6].fetch_or(uint64_t(1) << (index & 63), std::memory_order_relaxed); // filled
+            }
+            return size_t(global::bit_ctz(bit));
+        }
+        bits = old | bit;
+    }
+}
+
+} // namespace core
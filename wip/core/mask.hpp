@@ -41,6 +41,20 @@ public:
      */
     size_t next() const;
 
+public:
+    /**
+     * @param  [in] idx word index, 0 ~ N - 1
+     * @return 64 flags of word, bit i is index idx * 64 + i
+     */
+    uint64_t word(size_t idx) const;
+
+public:
+    /**
+     * @brief set all flags off
+     * @return this
+     */
+    Mask<N>& clear();
+
 private:
     /**
      * @brief bit-maks flags
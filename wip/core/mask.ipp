@@ -11,6 +11,8 @@ public:
     Mask<0>& toggle(uint64_t)  { return *this; }
     bool check(uint64_t) const { return false; }
     size_t next() const        { return -1; }
+    uint64_t word(size_t) const { return 0; }
+    Mask<0>& clear()           { return *this; }
 };
 
 template<size_t N> Mask<N>& Mask<N>::on(size_t index) {
@@ -44,4 +46,15 @@ template<size_t N> size_t Mask<N>::next() const {
     return size_t(-1); // not found
 }
 
+template<size_t N> uint64_t Mask<N>::word(size_t index) const {
+    return flags[index];
+}
+
+template<size_t N> Mask<N>& Mask<N>::clear() {
+    for(size_t i = 0; i < N; ++i) {
+        flags[i] = 0;
+    }
+    return *this;
+}
+
 }
@@ -0,0 +1,67 @@
+#ifndef CORE_OFFSET_HPP
+#define CORE_OFFSET_HPP
+
+#include "../global/internal/include.h"
+#include <type_traits>
+
+namespace core {
+
+/**
+ * @brief self-relative pointer, stores distance from itself to the target
+ * @note  survives remapping at another base when the pointer and the target are in the same mapping,
+ *        cannot point to itself because distance 0 is null
+ */
+template<typename T> class Offset {
+public:
+    Offset() noexcept = default;
+
+public:
+    /**
+     * @param [in] ptr target, nullptr is null
+     */
+    Offset(T* ptr) noexcept;
+
+public:
+    /**
+     * @param [in] in rebased to this address
+     */
+    Offset(const Offset& in) noexcept;
+
+public:
+    /**
+     * @param [in] ptr target, nullptr is null
+     * @return this
+     */
+    Offset& operator=(T* ptr) noexcept;
+
+public:
+    /**
+     * @param [in] in rebased to this address
+     * @return this
+     */
+    Offset& operator=(const Offset& in) noexcept;
+
+public:
+    /**
+     * @return target, nullptr if null
+     */
+    T* get() const noexcept;
+
+public:
+    T* operator->() const noexcept { return get(); }
+    operator T*() const noexcept { return get(); }
+
+public:
+    template<typename U = T> std::enable_if_t<!std::is_void_v<U>, U&> operator*() const noexcept { return *get(); }
+
+private:
+    /**
+     * @brief target address - this address, 0 is null
+     */
+    intptr_t diff = 0;
+};
+
+} // namespace core
+
+#include "offset.ipp"
+#endif
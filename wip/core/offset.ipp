@@ -0,0 +1,28 @@
+#ifndef CORE_OFFSET_HPP
+#    include "offset.hpp"
+#endif
+
+namespace core {
+
+template<typename T> Offset<T>::Offset(T* ptr) noexcept {
+    *this = ptr;
+}
+
+template<typename T> Offset<T>::Offset(const Offset& in) noexcept {
+    *this = in.get();
+}
+
+template<typename T> Offset<T>& Offset<T>::operator=(T* ptr) noexcept {
+    diff = ptr ? intptr_t(ptr) - intptr_t(this) : 0; // 0 is null
+    return *this;
+}
+
+template<typename T> Offset<T>& Offset<T>::operator=(const Offset& in) noexcept {
+    return *this = in.get();
+}
+
+template<typename T> T* Offset<T>::get() const noexcept {
+    return diff ? reinterpret_cast<T*>(intptr_t(this) + diff) : nullptr;
+}
+
+} // namespace core
@@ -0,0 +1,42 @@
+#ifndef CORE_SPIN_HPP
+#define CORE_SPIN_HPP
+
+#include "../global/pal.hpp"
+#include <atomic>
+
+namespace core {
+
+//! @brief spin lock, address free: usable in memory shared between processes
+class Spin {
+public:
+    /**
+     * @brief wait until locked
+     */
+    void lock() noexcept;
+
+public:
+    /**
+     * @return false if locked by other
+     */
+    bool try_lock() noexcept;
+
+public:
+    /**
+     * @brief release lock
+     */
+    void unlock() noexcept;
+
+private:
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+private:
+    /**
+     * @brief 0 is unlocked
+     */
+    std::atomic<uint32_t> flag{ 0 };
+};
+
+} // namespace core
+
+#include "spin.ipp"
+#endif
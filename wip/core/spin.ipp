@@ -0,0 +1,24 @@
+#ifndef CORE_SPIN_HPP
+#    include "spin.hpp"
+#endif
+
+namespace core {
+
+inline void Spin::lock() noexcept {
+    while(flag.exchange(1, std::memory_order_acquire) != 0) {
+        // read only wait, for cache line
+        while(flag.load(std::memory_order_relaxed) != 0) {
+            global::pal_pause();
+        }
+    }
+}
+
+inline bool Spin::try_lock() noexcept {
+    return flag.load(std::memory_order_relaxed) == 0 && flag.exchange(1, std::memory_order_acquire) == 0;
+}
+
+inline void Spin::unlock() noexcept {
+    flag.store(0, std::memory_order_release);
+}
+
+} // namespace core
@@ -1,6 +1,16 @@
 #ifndef GLOBAL_INTERNAL_CONFIG_H
 #define GLOBAL_INTERNAL_CONFIG_H
 
+// latency sampling period of acquire / release, 1 is every call, 0 is disabled
+#ifndef MEM_LATENCY
+#    define MEM_LATENCY 0
+#endif
+
+// bytes of empty chunks kept across size classes to skip syscall, 0 is disabled
+#ifndef MEM_CACHE
+#    define MEM_CACHE (32 << 20)
+#endif
+
 namespace global {
 
 static constexpr size_t PAL_PAGE     = 1 << 14; //!< 16 KiB: memory page allocate unit (multiple of)
@@ -2,6 +2,7 @@
 #define GLOBAL_INTERNAL_INCLUDE_H
 
 // C++ standard
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 
@@ -1,3 +1,8 @@
+#ifndef GLOBAL_NUM_HPP
+#define GLOBAL_NUM_HPP
+
+#include "internal/include.h"
+
 namespace global {
 
 constexpr size_t num_align(size_t in, size_t align) {
@@ -5,3 +10,4 @@ constexpr size_t num_align(size_t in, size_t align) {
 }
 
 } // namespace global
+#endif
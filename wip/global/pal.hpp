@@ -1,10 +1,10 @@
 #ifndef GLOBAL_PAL_HPP
 #define GLOBAL_PAL_HPP
 
+#include <cstring>
 #include <new>
 
-#include "internal/config.h"
-#include "internal/target.h"
+#include "internal/include.h"
 
 // WIN libraries
 #if CHECK_TARGET(OS_WINDOWS)
@@ -13,7 +13,14 @@
 
 // POSIX libraries
 #if CHECK_TARGET(OS_POSIX)
+#    include <fcntl.h>
 #    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    if __has_include(<execinfo.h>)
+#        include <execinfo.h>
+#        define PAL_BACKTRACE 1
+#    endif
 #endif
 
 #include "bit.hpp"
@@ -33,6 +40,17 @@ namespace global {
  */
 CXX_FORCE_INLINE void pal_pause() noexcept;
 
+/**
+ * @brief prefetch cache line for read, hint only
+ */
+CXX_FORCE_INLINE void pal_prefetch(const void* ptr) noexcept;
+
+/**
+ * @brief read cycle counter, rdtsc or cntvct, not serialized
+ * @note  tick is not calibrated to time, compare only on same machine
+ */
+CXX_FORCE_INLINE uint64_t pal_tick() noexcept;
+
 /**
  * @brief call VirtualAlloc or mmap
  *
@@ -50,6 +68,161 @@ template<typename T = void> T* pal_valloc(size_t byte = PAL_PAGE, size_t align =
  */
 void pal_vfree(void* ptr, size_t byte = 16384) noexcept;
 
+/**
+ * @brief call MapViewOfFileEx or mmap with MAP_SHARED
+ *
+ * @param [in] path  file path, created if not exists, extended if shorter than byte
+ * @param [in] byte  map size, value will be aligned to 16KiB
+ * @param [in] align address alignment, power of 2, ignored if base is not nullptr
+ * @param [in] base  OPTIONAL: fixed address to map, must be aligned, nullptr is any aligned address
+ * @return mapped file view, nullptr if failed or base is not available
+ */
+void* pal_fmap(const char* path, size_t byte, size_t align = PAL_BOUNDARY, void* base = nullptr) noexcept;
+
+/**
+ * @brief get real mapping size of valloc
+ *
+ * @param [in] byte requested size
+ * @return aligned to 16KiB, or 2MiB if large
+ */
+constexpr size_t pal_vsize(size_t byte) noexcept;
+
+/**
+ * @brief call mremap, resize in place, or move pages to new aligned address without copy
+ *
+ * @param [in] ptr   pointer from valloc or vremap
+ * @param [in] old   same size used when calling valloc or vremap
+ * @param [in] byte  new size
+ * @param [in] align address alignment when pages are moved
+ * @return resized range, nullptr if failed or not supported (WIN, non Linux), ptr is kept then
+ */
+void* pal_vremap(void* ptr, size_t old, size_t byte, size_t align = PAL_BOUNDARY) noexcept;
+
+/**
+ * @brief populate pages to remove first touch page faults, madvise(MADV_POPULATE_WRITE) or touch
+ *
+ * @param [in] ptr  pointer from valloc, fmap or smap, or inner page aligned address
+ * @param [in] byte range size
+ * @return false if failed
+ */
+bool pal_vfault(void* ptr, size_t byte) noexcept;
+
+/**
+ * @brief call VirtualLock or mlock, populate and keep pages in memory
+ *
+ * @param [in] ptr  pointer from valloc, fmap or smap, or inner page aligned address
+ * @param [in] byte range size
+ * @return false if failed, e.g. RLIMIT_MEMLOCK exceeded
+ */
+bool pal_vlock(void* ptr, size_t byte) noexcept;
+
+/**
+ * @brief call VirtualUnlock or munlock
+ *
+ * @param [in] ptr  pointer from vlock
+ * @param [in] byte same size used when calling vlock
+ */
+void pal_vunlock(void* ptr, size_t byte) noexcept;
+
+/**
+ * @brief discard pages and release physical memory, range stays mapped and refaults on next touch
+ * @note  contents are undefined after, zero or old data by lazy, locked pages are not discarded
+ *
+ * @param [in] ptr  page aligned address in pointer from valloc
+ * @param [in] byte range size, multiple of page
+ * @param [in] lazy OPTIONAL: MADV_FREE, reclaimed by kernel under pressure only, false is MADV_DONTNEED
+ * @return false if failed
+ */
+bool pal_vreset(void* ptr, size_t byte, bool lazy = false) noexcept;
+
+/**
+ * @brief call CreateFileMapping with paging file or shm_open, and map view
+ *
+ * @param [in]  name    segment name, POSIX name starts with '/'
+ * @param [in]  byte    map size, value will be aligned to 16KiB
+ * @param [out] created OPTIONAL: true if this call created the segment, new segment is zero
+ * @param [in]  align   address alignment, power of 2, ignored if base is not nullptr
+ * @param [in]  base    OPTIONAL: fixed address to map, must be aligned, nullptr is any aligned address
+ * @return mapped segment view, nullptr if failed or base is not available
+ */
+void* pal_smap(const char* name, size_t byte, bool* created = nullptr, size_t align = PAL_BOUNDARY, void* base = nullptr) noexcept;
+
+/**
+ * @brief remove segment name, mapped views are kept until unmapped
+ *
+ * @param [in] name segment name from smap
+ */
+void pal_sunlink(const char* name) noexcept;
+
+/**
+ * @brief call UnmapViewOfFile or munmap, does not flush
+ *
+ * @param [in] ptr  pointer from fmap or smap
+ * @param [in] byte same size used when calling fmap
+ */
+void pal_funmap(void* ptr, size_t byte) noexcept;
+
+/**
+ * @brief call FlushViewOfFile or msync, write back dirty pages synchronously
+ *
+ * @param [in] ptr  pointer from fmap, or inner page aligned address
+ * @param [in] byte range size
+ * @return false if failed
+ */
+bool pal_fsync(void* ptr, size_t byte) noexcept;
+
+/**
+ * @brief capture return addresses of calling thread, backtrace or RtlCaptureStackBackTrace
+ *
+ * @param [out] out  frames, innermost first
+ * @param [in]  max  capacity of out
+ * @param [in]  skip innermost frames to skip, this function is skipped always
+ * @return captured frame count, 0 if not supported
+ */
+size_t pal_stack(void** out, size_t max, size_t skip = 0) noexcept;
+
+/**
+ * @brief page size detected at first call, e.g. 4KiB or 16KiB, PAL_PAGE is the compile time upper bound
+ */
+size_t pal_page() noexcept;
+
+/**
+ * @brief transparent huge page size detected at first call, Linux hpage_pmd_size, WIN large page minimum
+ *
+ * @return 0 if not supported
+ */
+size_t pal_hugepage() noexcept;
+
+/**
+ * @brief L1 data cache line size detected at first call
+ *
+ * @return 64 if unknown
+ */
+size_t pal_cacheline() noexcept;
+
+/**
+ * @brief advise transparent huge pages for range, hint only
+ *
+ * @return false if not supported, or range has no whole huge page
+ */
+bool pal_vhuge(void* ptr, size_t byte) noexcept;
+
+/**
+ * @brief usage percent to pressure, 0 up to 80% usage, then linear to 100 at full usage
+ *
+ * @param [in] usage percent of limit in use
+ * @return percent 0 ~ 100
+ */
+int pal_squeeze(double usage) noexcept;
+
+/**
+ * @brief memory pressure, Linux PSI some avg10, or cgroup memory.current / memory.high, WIN memory load
+ * @note  PSI is a stall percent, usage of cgroup and WIN is scaled by pal_squeeze to be comparable
+ *
+ * @return percent 0 ~ 100, -1 if not supported
+ */
+int pal_pressure() noexcept;
+
 } // namespace global
 
 //! @NOTE: like as "Windows.h"
@@ -63,6 +236,20 @@ extern "C" {
     //__declspec(dllimport) void*  __stdcall VirtualAlloc(void*, size_t, uint32_t, uint32_t);
     //__declspec(dllimport) int    __stdcall VirtualFree(void*, size_t, uint32_t);
     //__declspec(dllimport) size_t __stdcall VirtualQuery(void*, void*, size_t);
+    //__declspec(dllimport) int    __stdcall VirtualLock(void*, size_t);
+    //__declspec(dllimport) int    __stdcall VirtualUnlock(void*, size_t);
+
+    //__declspec(dllimport) void* __stdcall CreateFileA(const char*, uint32_t, uint32_t, void*, uint32_t, uint32_t, void*);
+    //__declspec(dllimport) void* __stdcall CreateFileMappingA(void*, void*, uint32_t, uint32_t, uint32_t, const char*);
+    //__declspec(dllimport) void* __stdcall MapViewOfFileEx(void*, uint32_t, uint32_t, uint32_t, size_t, void*);
+    //__declspec(dllimport) int   __stdcall UnmapViewOfFile(const void*);
+    //__declspec(dllimport) int   __stdcall FlushViewOfFile(const void*, size_t);
+    //__declspec(dllimport) int   __stdcall CloseHandle(void*);
+    //__declspec(dllimport) uint32_t __stdcall GetLastError();
+    //__declspec(dllimport) int   __stdcall GlobalMemoryStatusEx(void*);
+    //__declspec(dllimport) uint16_t __stdcall RtlCaptureStackBackTrace(uint32_t, uint32_t, void**, uint32_t*);
+    //__declspec(dllimport) void     __stdcall GetSystemInfo(void*);
+    //__declspec(dllimport) size_t   __stdcall GetLargePageMinimum();
 }
 #endif
 
@@ -18,7 +18,47 @@ CXX_FORCE_INLINE void pal_pause() noexcept {
 #endif
 }
 
-template<> void* pal_valloc<void>(size_t byte, size_t align) noexcept {
+CXX_FORCE_INLINE void pal_prefetch(const void* ptr) noexcept {
+#if CHECK_TARGET(COMP_MSVC | ARCH_X86)
+    _mm_prefetch(static_cast<const char*>(ptr), 3); // _MM_HINT_T0
+
+#elif CHECK_TARGET(COMP_MSVC | ARCH_ARM)
+    __prefetch(ptr);
+
+#elif TARGET_COMP & (COMP_CLANG | COMP_GCC)
+    __builtin_prefetch(ptr, 0, 3);
+
+#else
+    (void)ptr;
+#endif
+}
+
+CXX_FORCE_INLINE uint64_t pal_tick() noexcept {
+#if CHECK_TARGET(COMP_MSVC | ARCH_X86)
+    return __rdtsc();
+
+#elif CHECK_TARGET(COMP_MSVC | ARCH_ARM | BITS_64)
+    return uint64_t(_ReadStatusReg(0x5F02)); // ARM64_CNTVCT
+
+#elif CHECK_TARGET(ARCH_X86) && (TARGET_COMP & (COMP_CLANG | COMP_GCC))
+    return __builtin_ia32_rdtsc();
+
+#elif CHECK_TARGET(ARCH_ARM | BITS_64) && (TARGET_COMP & (COMP_CLANG | COMP_GCC))
+    uint64_t out;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(out));
+    return out;
+
+#elif CHECK_TARGET(ARCH_ARM | BITS_32) && (TARGET_COMP & (COMP_CLANG | COMP_GCC))
+    uint64_t out;
+    __asm__ __volatile__("mrrc p15, 1, %Q0, %R0, c14" : "=r"(out)); // CNTVCT
+    return out;
+
+#else
+    return 0; // not supported
+#endif
+}
+
+template<> inline void* pal_valloc<void>(size_t byte, size_t align) noexcept {
     if(byte >= PAL_HUGEPAGE) {
         byte = bit_align(byte, PAL_HUGEPAGE);             // aligned to 2MiB
         align = bit_pow2(bit_align(align, PAL_HUGEPAGE)); // aligned to 2MiB to power of 2
@@ -122,7 +162,7 @@ template<typename T> T* pal_valloc(size_t byte, size_t align) noexcept {
 #endif
 }
 
-void pal_vfree(void* ptr, size_t byte) noexcept {
+inline void pal_vfree(void* ptr, size_t byte) noexcept {
     if(!ptr) return;
 
 #if CHECK_TARGET(OS_WINDOWS)
@@ -157,4 +197,492 @@ void pal_vfree(void* ptr, size_t byte) noexcept {
 #endif
 }
 
+constexpr size_t pal_vsize(size_t byte) noexcept {
+    return byte >= PAL_HUGEPAGE ? bit_align(byte, PAL_HUGEPAGE) : bit_align(byte, PAL_PAGE);
+}
+
+inline void* pal_vremap(void* ptr, size_t old, size_t byte, size_t align) noexcept {
+    if(!ptr) return nullptr;
+
+    old  = pal_vsize(old);
+    byte = pal_vsize(byte);
+    if(old == byte) {
+        return ptr; // same mapping
+    }
+
+#if CHECK_TARGET(OS_POSIX) && defined(MREMAP_MAYMOVE) && defined(MREMAP_FIXED)
+    // first: in place, shrink always succeeds
+    void* out = mremap(ptr, old, byte, 0);
+    if(out != MAP_FAILED) {
+        return out;
+    }
+
+    // second: move pages onto new aligned reservation
+    void* dest = pal_valloc<void>(byte, align);
+    if(!dest) {
+        return nullptr;
+    }
+    out = mremap(ptr, old, byte, MREMAP_MAYMOVE | MREMAP_FIXED, dest);
+    if(out == MAP_FAILED) {
+        pal_vfree(dest, byte); // rollback
+        return nullptr;
+    }
+    return out;
+
+#else
+    (void)align;
+    return nullptr; // not supported: copy by caller
+#endif
+}
+
+inline bool pal_vfault(void* ptr, size_t byte) noexcept {
+    if(!ptr) return false;
+
+#if CHECK_TARGET(OS_POSIX) && defined(MADV_POPULATE_WRITE)
+    if(madvise(ptr, byte, MADV_POPULATE_WRITE) == 0) {
+        return true; // Linux 5.14+
+    }
+#endif
+
+    // fallback: touch every page
+    volatile uint8_t* page = static_cast<volatile uint8_t*>(ptr);
+    const size_t      step = pal_page();
+    for(size_t i = 0; i < byte; i += step) {
+        page[i] = page[i];
+    }
+    return true;
+}
+
+inline bool pal_vlock(void* ptr, size_t byte) noexcept {
+    if(!ptr) return false;
+
+#if CHECK_TARGET(OS_WINDOWS)
+    return VirtualLock(ptr, byte) != 0;
+
+#elif CHECK_TARGET(OS_POSIX)
+    return mlock(ptr, byte) == 0;
+
+#else
+    (void)byte;
+    return false;
+#endif
+}
+
+inline void pal_vunlock(void* ptr, size_t byte) noexcept {
+    if(!ptr) return;
+
+#if CHECK_TARGET(OS_WINDOWS)
+    VirtualUnlock(ptr, byte);
+
+#elif CHECK_TARGET(OS_POSIX)
+    munlock(ptr, byte);
+
+#else
+    (void)byte;
+#endif
+}
+
+inline bool pal_vreset(void* ptr, size_t byte, bool lazy) noexcept {
+    if(!ptr || byte == 0) return false;
+
+#if CHECK_TARGET(OS_WINDOWS)
+    (void)lazy;
+    return VirtualAlloc(ptr, byte, 0x80000, 0x4) != nullptr; // MEM_RESET, lazy in any case
+
+#elif CHECK_TARGET(OS_POSIX)
+#    if defined(MADV_FREE)
+    if(lazy && madvise(ptr, byte, MADV_FREE) == 0) {
+        return true; // Linux 4.5+
+    }
+#    endif
+    (void)lazy;
+    return madvise(ptr, byte, MADV_DONTNEED) == 0;
+
+#else
+    (void)byte;
+    (void)lazy;
+    return false;
+#endif
+}
+
+#if CHECK_TARGET(OS_WINDOWS)
+/**
+ * @brief WIN: create section from file handle or paging file, and map view
+ *
+ * @param [in] file  file handle, INVALID_HANDLE_VALUE is paging file
+ * @param [in] name  section name, nullptr is anonymous
+ * @param [in] byte  aligned map size
+ * @param [in] align aligned address alignment
+ * @param [in] base  fixed address, nullptr is any aligned address
+ * @return view, nullptr if failed
+ */
+inline void* pal_hmap(void* file, const char* name, size_t byte, size_t align, void* base) noexcept {
+    // param: PAGE_READWRITE, file is extended to byte
+    void* view = CreateFileMappingA(file, nullptr, 0x4, uint32_t(uint64_t(byte) >> 32), uint32_t(byte), name);
+    if(!view) {
+        return nullptr;
+    }
+
+    // find aligned address: reserve, release, then map
+    if(!base) {
+        // param: MEM_RESERVE, PAGE_NOACCESS
+        void* reserved = VirtualAlloc(nullptr, byte + align, 0x2000, 0x1);
+        if(reserved) {
+            base = reinterpret_cast<void*>(bit_align(uint64_t(reserved), align));
+            VirtualFree(reserved, 0, 0x8000); // param: MEM_RELEASE
+        }
+    }
+
+    // param: FILE_MAP_ALL_ACCESS
+    void* ptr = MapViewOfFileEx(view, 0xF001F, 0, 0, byte, base);
+    CloseHandle(view); // view keeps section reference
+    return ptr;
+}
+
+#elif CHECK_TARGET(OS_POSIX)
+/**
+ * @brief POSIX: map file descriptor with MAP_SHARED, does not close
+ *
+ * @param [in] fd    file or shared memory descriptor, extended if shorter than byte
+ * @param [in] byte  aligned map size
+ * @param [in] align aligned address alignment
+ * @param [in] base  fixed address, nullptr is any aligned address
+ * @return view, nullptr if failed
+ */
+inline void* pal_fdmap(int fd, size_t byte, size_t align, void* base) noexcept {
+    // extend file, new area is zero
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (size_t(info.st_size) < byte && ftruncate(fd, off_t(byte)) != 0)) {
+        return nullptr;
+    }
+
+    void* ptr = MAP_FAILED;
+    if(base) {
+        // fixed address: do not replace existing mapping
+        ptr = mmap(base, byte, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(ptr != MAP_FAILED && ptr != base) {
+            munmap(ptr, byte); // hint ignored
+            ptr = MAP_FAILED;
+        }
+    }
+    else {
+        // reserve address range, then overwrite the aligned part with file
+        const size_t ALLOC = bit_align(byte + align, align);
+
+        void* reserved = mmap(NULL, ALLOC, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if(reserved != MAP_FAILED) {
+            uintptr_t allocated = uintptr_t(reserved);          // casting
+            uintptr_t aligned   = bit_align(allocated, align); // aligned address
+            uintptr_t moved     = aligned - allocated;         // moved
+            uintptr_t remained  = ALLOC - byte - moved;        // remained
+
+            ptr = mmap(reinterpret_cast<void*>(aligned), byte, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            if(ptr == MAP_FAILED) {
+                munmap(reserved, ALLOC); // rollback
+            }
+            else {
+                if(moved) {
+                    munmap(reserved, moved); // trim front
+                }
+                if(remained) {
+                    munmap(reinterpret_cast<char*>(aligned + byte), remained); // trim back
+                }
+            }
+        }
+    }
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+#endif
+
+inline void* pal_fmap(const char* path, size_t byte, size_t align, void* base) noexcept {
+    byte  = bit_align(byte, PAL_PAGE);                 // aligned to 16KiB
+    align = bit_pow2(bit_align(align, PAL_BOUNDARY)); // align to 64KiB to power of 2
+
+    // protect overflow and check fixed address
+    if(!path || byte > (~size_t(0) - (align * 2)) || (base && !bit_aligned(uint64_t(base), PAL_BOUNDARY))) {
+        return nullptr; // invalid
+    }
+    void* ptr = nullptr;
+
+#if CHECK_TARGET(OS_WINDOWS)
+    // param: GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL
+    void* file = CreateFileA(path, 0xC0000000, 0x3, nullptr, 4, 0x80, nullptr);
+    if(file == reinterpret_cast<void*>(-1)) {
+        return nullptr;
+    }
+    ptr = pal_hmap(file, nullptr, byte, align, base);
+    CloseHandle(file);
+
+#elif CHECK_TARGET(OS_POSIX)
+    int fd = open(path, O_RDWR | O_CREAT, 0600);
+    if(fd < 0) {
+        return nullptr;
+    }
+    ptr = pal_fdmap(fd, byte, align, base);
+    close(fd); // mapping keeps file reference
+
+#else
+    (void)base;
+    return nullptr; // not supported
+#endif
+    return ptr;
+}
+
+inline void* pal_smap(const char* name, size_t byte, bool* created, size_t align, void* base) noexcept {
+    byte  = bit_align(byte, PAL_PAGE);                 // aligned to 16KiB
+    align = bit_pow2(bit_align(align, PAL_BOUNDARY)); // align to 64KiB to power of 2
+
+    // protect overflow and check fixed address
+    if(!name || byte > (~size_t(0) - (align * 2)) || (base && !bit_aligned(uint64_t(base), PAL_BOUNDARY))) {
+        return nullptr; // invalid
+    }
+    void* ptr = nullptr;
+
+#if CHECK_TARGET(OS_WINDOWS)
+    ptr = pal_hmap(reinterpret_cast<void*>(-1), name, byte, align, base); // paging file backed
+    if(created) {
+        *created = ptr && GetLastError() != 183; // ERROR_ALREADY_EXISTS
+    }
+
+#elif CHECK_TARGET(OS_POSIX)
+    bool first = true;
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600); // try create
+    if(fd < 0) {
+        first = false;
+        fd    = shm_open(name, O_RDWR, 0600); // attach
+        if(fd < 0) {
+            return nullptr;
+        }
+    }
+    ptr = pal_fdmap(fd, byte, align, base);
+    close(fd); // mapping keeps segment reference
+
+    if(!ptr && first) {
+        shm_unlink(name); // rollback
+    }
+    if(created) {
+        *created = ptr && first;
+    }
+
+#else
+    (void)created;
+    (void)base;
+    return nullptr; // not supported
+#endif
+    return ptr;
+}
+
+inline void pal_sunlink(const char* name) noexcept {
+    if(!name) return;
+
+#if CHECK_TARGET(OS_POSIX)
+    shm_unlink(name);
+#endif
+    // WIN: section is destroyed with last view
+}
+
+inline void pal_funmap(void* ptr, size_t byte) noexcept {
+    if(!ptr) return;
+
+#if CHECK_TARGET(OS_WINDOWS)
+    (void)byte;
+    UnmapViewOfFile(ptr);
+
+#elif CHECK_TARGET(OS_POSIX)
+    munmap(ptr, bit_align(byte, PAL_PAGE)); // aligned to 16KiB
+
+#else
+    (void)byte;
+#endif
+}
+
+inline bool pal_fsync(void* ptr, size_t byte) noexcept {
+    if(!ptr) return false;
+
+#if CHECK_TARGET(OS_WINDOWS)
+    return FlushViewOfFile(ptr, byte) != 0;
+
+#elif CHECK_TARGET(OS_POSIX)
+    return msync(ptr, byte, MS_SYNC) == 0;
+
+#else
+    (void)byte;
+    return false;
+#endif
+}
+
+#if CHECK_TARGET(OS_POSIX)
+//! @brief read small text file, return length, -1 if failed
+inline int pal_fread(const char* path, char* out, size_t byte) noexcept {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        return -1;
+    }
+    ssize_t len = read(fd, out, byte - 1);
+    close(fd);
+    if(len < 0) {
+        return -1;
+    }
+    out[len] = 0;
+    return int(len);
+}
+#endif
+
+inline size_t pal_stack(void** out, size_t max, size_t skip) noexcept {
+#if CHECK_TARGET(OS_WINDOWS)
+    return RtlCaptureStackBackTrace(uint32_t(skip + 1), uint32_t(max), out, nullptr);
+
+#elif defined(PAL_BACKTRACE)
+    void* temp[128];
+    int   cnt = backtrace(temp, 128);
+
+    size_t top = 0;
+    for(size_t i = skip + 1; i < size_t(cnt) && top < max; ++i) {
+        out[top++] = temp[i];
+    }
+    return top;
+
+#else
+    (void)out;
+    (void)max;
+    (void)skip;
+    return 0;
+#endif
+}
+
+inline size_t pal_page() noexcept {
+    static const size_t out = []() -> size_t {
+#if CHECK_TARGET(OS_WINDOWS)
+        // SYSTEM_INFO binary layout
+        struct {
+            uint16_t arch;
+            uint16_t reserved;
+            uint32_t page;
+            uint8_t  rest[40];
+        } info = {};
+        GetSystemInfo(reinterpret_cast<SYSTEM_INFO*>(&info));
+        return info.page ? info.page : 4096;
+
+#elif CHECK_TARGET(OS_POSIX)
+        const long page = sysconf(_SC_PAGESIZE);
+        return page > 0 ? size_t(page) : 4096;
+
+#else
+        return 4096;
+#endif
+    }();
+    return out;
+}
+
+inline size_t pal_hugepage() noexcept {
+    static const size_t out = []() -> size_t {
+#if CHECK_TARGET(OS_WINDOWS)
+        return GetLargePageMinimum();
+
+#elif CHECK_TARGET(OS_POSIX)
+        char buf[64];
+        if(pal_fread("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", buf, sizeof(buf)) > 0) {
+            return size_t(std::strtoull(buf, nullptr, 10));
+        }
+        return 0;
+
+#else
+        return 0;
+#endif
+    }();
+    return out;
+}
+
+inline size_t pal_cacheline() noexcept {
+    static const size_t out = []() -> size_t {
+#if CHECK_TARGET(OS_POSIX)
+#    ifdef _SC_LEVEL1_DCACHE_LINESIZE
+        const long line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+        if(line > 0) {
+            return size_t(line);
+        }
+#    endif
+        char buf[64];
+        if(pal_fread("/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size", buf, sizeof(buf)) > 0) {
+            const size_t line = size_t(std::strtoull(buf, nullptr, 10));
+            if(line) {
+                return line;
+            }
+        }
+#endif
+        return 64;
+    }();
+    return out;
+}
+
+inline bool pal_vhuge(void* ptr, size_t byte) noexcept {
+    const size_t huge = pal_hugepage();
+    if(!ptr || huge == 0) {
+        return false; // not supported
+    }
+
+    // whole huge pages in range
+    const uintptr_t begin = bit_align(uintptr_t(ptr), huge);
+    const uintptr_t end   = (uintptr_t(ptr) + byte) & ~uintptr_t(huge - 1);
+    if(begin >= end) {
+        return false;
+    }
+
+#if CHECK_TARGET(OS_POSIX) && defined(MADV_HUGEPAGE)
+    return madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) == 0;
+
+#else
+    return false; // WIN: large pages need privilege and MEM_LARGE_PAGES at allocation
+#endif
+}
+
+inline int pal_squeeze(double usage) noexcept {
+    static constexpr double FLOOR = 80; // usage percent of no pressure
+
+    if(usage <= FLOOR) {
+        return 0;
+    }
+    return usage < 100 ? int((usage - FLOOR) * 100 / (100 - FLOOR)) : 100;
+}
+
+inline int pal_pressure() noexcept {
+#if CHECK_TARGET(OS_WINDOWS)
+    // MEMORYSTATUSEX binary layout
+    struct {
+        uint32_t size;
+        uint32_t load;
+        uint64_t value[7];
+    } status = { sizeof(status) };
+
+    if(!GlobalMemoryStatusEx(reinterpret_cast<MEMORYSTATUSEX*>(&status))) {
+        return -1;
+    }
+    return pal_squeeze(double(status.load));
+
+#elif CHECK_TARGET(OS_POSIX)
+    char buf[256];
+
+    // PSI: "some avg10=1.23 avg60=..."
+    if(pal_fread("/proc/pressure/memory", buf, sizeof(buf)) > 0) {
+        const char* avg = std::strstr(buf, "avg10=");
+        if(avg) {
+            return int(std::strtod(avg + 6, nullptr) + 0.5);
+        }
+    }
+
+    // cgroup v2: usage over soft limit
+    if(pal_fread("/sys/fs/cgroup/memory.high", buf, sizeof(buf)) > 0 && buf[0] != 'm') { // "max"
+        const double high = std::strtod(buf, nullptr);
+        if(high > 0 && pal_fread("/sys/fs/cgroup/memory.current", buf, sizeof(buf)) > 0) {
+            return pal_squeeze(std::strtod(buf, nullptr) * 100 / high);
+        }
+    }
+    return -1;
+
+#else
+    return -1;
+#endif
+}
+
 } // namespace global
@@ -1,33 +1,129 @@
 #ifndef MEM_ALLOCATOR_HPP
 #define MEM_ALLOCATOR_HPP
 
+#include "../core/atomicmask.hpp"
 #include "../core/mask.hpp"
+#include "../core/offset.hpp"
+#include "../core/spin.hpp"
 #include "../global/pal.hpp"
 #include "../global/num.hpp"
+#include "backend.hpp"
+#include "cache.hpp"
+#include "heap.hpp"
+#include "latency.hpp"
+#include "pagemap.hpp"
+#include "profiler.hpp"
+#include "registry.hpp"
+#include "tag.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <utility>
 #include <type_traits>
 
-template<size_t, bool = false> class Allocator;
+//! @brief free block tracking of chunk
+enum class Track : uint8_t {
+    BITMAP, //!< bitmap scan, default
+    LIST,   //!< intrusive free list through free blocks, O(1) LIFO reuse, bitmap is built on demand
+    AUTO,   //!< Policy only: Tracking of block size
+};
+
+/**
+ * @brief tracking policy of block size, specialize before use to choose per size class
+ *
+ * [usage]
+ * template<> struct Tracking<64> {
+ *     static constexpr Track MODE   = Track::LIST;
+ *     static constexpr bool  HARDEN = true;
+ * };
+ */
+template<size_t BLOCK> struct Tracking {
+    static constexpr Track MODE   = Track::BITMAP; //!< chunk tracking
+    static constexpr bool  HARDEN = false;         //!< LIST: encode links by chunk key, validate on pop, abort if corrupted
+};
+
+/**
+ * @brief threading of allocator
+ * @note  SHARED: acquire, release and deferred release are thread safe, other calls need no concurrent use,
+ *        not registered to Registry, so pressure does not shrink it, and sampling by Profiler is off
+ */
+enum class Thread : uint8_t {
+    LOCAL,  //!< acquired by owner thread, released by any thread as remote free, default
+    SINGLE, //!< one thread only, no remote free and no abandoned chunk, foreign release aborts
+    SHARED, //!< any thread, lock-free on the current chunk, bitmap tracking, for size classes too cold for per-thread chunks
+};
+
+//! @brief chunk memory of allocator without heap or backend
+enum class Backing : uint8_t {
+    CACHED, //!< Cache, then syscall, default
+    DIRECT, //!< syscall only
+    HUGE,   //!< CACHED, and advise transparent huge pages for chunks covering pal_hugepage()
+};
+
+/**
+ * @brief default policy traits of Allocator and Pool, derive and hide members to tune a use site
+ *
+ * [usage]
+ * struct Hot : Policy {
+ *     static constexpr size_t CHUNK = 1 << 20;
+ *     static constexpr Track  TRACK = Track::LIST;
+ *     static constexpr bool   STATS = false;
+ * };
+ * Allocator<64, Hot> alloc;
+ */
+struct Policy {
+    static constexpr size_t  CHUNK   = 0;               //!< chunk size, power of 2 from PAL_BOUNDARY, 0 is by block size
+    static constexpr Track   TRACK   = Track::AUTO;     //!< free block tracking
+    static constexpr bool    HARDEN  = false;           //!< LIST: link hardening, or by Tracking
+    static constexpr Thread  THREAD  = Thread::LOCAL;   //!< threading
+    static constexpr Backing BACKING = Backing::CACHED; //!< chunk memory
+    static constexpr bool    STATS   = true;            //!< latency (MEM_LATENCY) and Profiler hooks
+};
+
+template<size_t, typename = Policy, bool = false> class Allocator;
 
 //! @brief non-aligned size allocator
-template<size_t N> class Allocator<N, false>
-    : public Allocator<global::bit_align(N, (N >= global::PAL_HUGEPAGE ? global::PAL_HUGEPAGE : sizeof(void*))), true> { };
+template<size_t N, typename P> class Allocator<N, P, false>
+    : public Allocator<global::bit_align(N, (N >= global::PAL_HUGEPAGE ? global::PAL_HUGEPAGE : sizeof(void*))), P, true> {
+public:
+    using Allocator<global::bit_align(N, (N >= global::PAL_HUGEPAGE ? global::PAL_HUGEPAGE : sizeof(void*))), P, true>::Allocator;
+};
 
 //! @brief pre-aligned size allocator
-template<size_t N, bool> class Allocator {
+template<size_t N, typename P, bool> class Allocator {
 public:
     static constexpr size_t BLOCK = global::bit_align(N, sizeof(void*)); //!< alginment (for safety)
 
 private:
     static constexpr bool WHOLE = BLOCK >= global::PAL_HUGEPAGE; //!< flag
 
+private:
+    static constexpr bool  CONCURRENT = P::THREAD == Thread::SHARED;                              //!< atomic chunk state
+    static constexpr Track TRACK      = CONCURRENT ? Track::BITMAP : P::TRACK == Track::AUTO ? Tracking<BLOCK>::MODE : P::TRACK; //!< by policy or size
+    static constexpr bool  INTRUSIVE  = !WHOLE && TRACK == Track::LIST;                            //!< free list tracking
+    static constexpr bool  HARDEN     = INTRUSIVE && (P::HARDEN || Tracking<BLOCK>::HARDEN);       //!< encoded links
+    static constexpr bool  REMOTE     = P::THREAD == Thread::LOCAL;                               //!< cross-thread release
+    static constexpr bool  STATS      = P::STATS;                                                 //!< latency and profiler
+
+private:
+    //! @brief policy chunk size check
+    static_assert(P::CHUNK == 0 || (global::bit_aligned(P::CHUNK) && P::CHUNK >= global::PAL_BOUNDARY));
+
+    //! @brief SHARED: WHOLE chunks are kept in vectors, not supported
+    static_assert(!(CONCURRENT && WHOLE));
+
+public:
+    //! @brief natural block alignment: lowest set bit of BLOCK, WHOLE block is aligned by pal_valloc
+    static constexpr size_t ALIGN = WHOLE ? global::PAL_HUGEPAGE : (BLOCK & (~BLOCK + 1));
+
 private:
     struct Meta;  //!< metadata, header
     struct Chunk; //!< chunk
     struct List;  //!< chunk as node, single linked list
     struct Array; //!< chunk pointer vector (for huge)
+    struct Table; //!< chunk id table, process wide
+    struct Hot;   //!< current chunk published to concurrent acquire
 
 private:
     using Stack = std::conditional_t<WHOLE, Array, List>; //!< List or Array selector
@@ -35,21 +131,59 @@ private:
 public:
     static constexpr size_t CHUNK =
         WHOLE ? BLOCK : // HUGE: fallback: 1 chunk as 1 block, with meta
+            P::CHUNK ? P::CHUNK : // POLICY: fixed by use site
             (global::bit_pow2(N * 15) <= global::PAL_BOUNDARY ? global::PAL_BOUNDARY : // SMALL: fixed 64KiB, default
                  (global::bit_pow2(N * 15)) // MEDIUM: at least 15 guaranteed, for 4KiB based on 64KiB
             );
     static constexpr size_t UNIT = Chunk::COUNT;
 
+private:
+    //! @brief policy chunk too small for one block with meta
+    static_assert(WHOLE || Chunk::COUNT > 0);
+
+public:
+    //! @brief bits of block index in locate, WHOLE has no slot
+    static constexpr size_t SLOT = WHOLE ? 0 : size_t(global::bit_log2(global::bit_pow2(UNIT)));
+
+    //! @brief max chunk id + 1 of locate, up to 2^20 chunks
+    static constexpr size_t IDS = SLOT >= 12 ? size_t(1) << (32 - SLOT) : size_t(1) << 20;
+
+public:
+    //! @brief chunk page preparation mode
+    enum class Warm : uint8_t {
+        LAZY,     //!< fault on first touch, default
+        PREFAULT, //!< populate pages when chunk is generated
+        LOCK,     //!< populate and lock pages when chunk is generated
+    };
+
 public:
     /**
-     * @brief constructor
+     * @brief constructor, registered to Registry
      */
-    Allocator() = default;
+    Allocator();
 
 public:
     /**
-     * @brief destructor
-     * @throw when chunk in use on debug
+     * @brief constructor, chunks are carved from heap instead of syscall
+     * @note  construct in the heap by Heap::root to restore after remap, WHOLE and SHARED are not supported
+     *
+     * @param [in] heap chunk source, nullptr is syscall
+     */
+    explicit Allocator(Heap* heap);
+
+public:
+    /**
+     * @brief constructor, chunks are generated by backend instead of syscall, registered to Registry
+     * @note  capacity is limited by backend, acquire returns nullptr when it is exhausted
+     *
+     * @param [in] backend chunk source, e.g. Region, nullptr is syscall
+     */
+    explicit Allocator(Backend* backend);
+
+public:
+    /**
+     * @brief destructor, chunks in use are abandoned to be adopted by other allocators of same size
+     * @note  heap and WHOLE chunks are destroyed
      */
     ~Allocator();
 
@@ -65,12 +199,115 @@ public:
 
 public:
     /**
-     * @brief free, crash when called from a different pool
+     * @brief malloc with placement new, address aligned to runtime alignment
+     *
+     * @tparam T type of the returned pointer
+     * @param [in] align address alignment, power of 2 up to PAL_PAGE
+     * @param [in] args  constructor parameters
+     * @return nullptr if failed or invalid alignment, or over ALIGN in SHARED
+     */
+    template<typename T = void, typename... Args> T* acquire_aligned(size_t align, Args&&... args) noexcept;
+
+public:
+    /**
+     * @brief malloc with placement new, in the chunk of hint at the free block nearest to it, for traversal locality
+     * @note  falls back to acquire if hint is not in a chunk of this allocator or the chunk is full,
+     *        LIST tracking takes any free block of the chunk, SHARED always falls back
+     *
+     * @tparam T type of the returned pointer
+     * @param [in] hint live block of this allocator, e.g. parent node, nullptr is acquire
+     * @param [in] args constructor parameters
+     * @return nullptr if failed
+     */
+    template<typename T = void, typename... Args> T* acquire_near(const void* hint, Args&&... args) noexcept;
+
+public:
+    /**
+     * @brief free, block of other allocator of same size is queued to its chunk as remote free
+     * @note  crash when called from a different size, or other heap
      *
      * @param [in] ptr pointer from valloc
      */
     template<typename T = void> void release(T* ptr);
 
+public:
+    /**
+     * @brief batch free, e.g. bucket of deferred reclamation
+     * @note  lists and counters are updated once per run of blocks in the same chunk
+     *
+     * @param [in] ptrs pointers from acquire
+     * @param [in] cnt  pointer count
+     */
+    template<typename T = void> void release(T* const* ptrs, size_t cnt);
+
+public:
+    /**
+     * @brief free later, destructor and release run by drain_deferred on owner thread or by Registry::reap
+     * @note  lock-free enqueue from any thread, heap allocator and failed enqueue release inline,
+     *        Registry::reap releases as remote free, so it skips WHOLE and SINGLE policy allocators
+     *
+     * @param [in] ptr pointer from acquire
+     */
+    template<typename T = void> void release_deferred(T* ptr);
+
+public:
+    /**
+     * @brief run destructors and release of deferred objects, owner thread
+     *
+     * @param [in] max OPTIONAL: max object count, rest is kept queued
+     * @return released object count
+     */
+    size_t drain_deferred(size_t max = ~size_t(0));
+
+public:
+    /**
+     * @brief check live block, by Pagemap then chunk bitmap
+     * @note  chunks carved from heap are not registered, ptr must be in the heap
+     *
+     * @param [in] ptr any address
+     * @return true if ptr is begin of live block of this allocator
+     */
+    bool check(const void* ptr) const noexcept;
+
+public:
+    /**
+     * @brief charge blocks to tenant budget, acquire over budget fails fast with nullptr
+     * @note  BLOCK is charged per acquire and refunded per release, live blocks are refunded by destructor,
+     *        bind while no block is live, heap allocator is bound again after restore
+     *
+     * @param [in] tag budget, nullptr unbinds
+     */
+    void bind(Tag* tag) noexcept;
+
+public:
+    /**
+     * @brief compact location of block, chunk id by process wide table and block index
+     * @note  chunks carved from heap, and WHOLE are not registered
+     *
+     * @param [in] ptr block of any allocator of this size
+     * @return id << SLOT | index, 0 if not registered
+     */
+    static uint32_t locate(const void* ptr) noexcept;
+
+public:
+    /**
+     * @brief block address of location, O(1)
+     *
+     * @param [in] loc location from locate
+     * @return nullptr if chunk of id is destroyed
+     */
+    static void* place(uint32_t loc) noexcept;
+
+public:
+    /**
+     * @brief per block counter of location, kept while the id lives, for stale handle check
+     *
+     * @param [in] loc  location from locate
+     * @param [in] make create counters of the chunk if not exist
+     * @return nullptr if not exist or failed
+     */
+    static uint8_t* generation(uint32_t loc, bool make = false) noexcept;
+
 public:
     /**
      * @brief syscall: create chunks
@@ -84,31 +321,246 @@ public:
     /**
      * @brief syscall: destroy empty chunks
      *
+     * @param [in] cnt OPTIONAL: max chunk count to destroy, default all
      * @return destroyed chunks count
      */
-    size_t shrink();
+    size_t shrink(size_t cnt = ~size_t(0));
+
+public:
+    /**
+     * @brief syscall: discard pages covered only by free blocks of partial chunks, live blocks are not moved
+     * @note  discarded pages are marked per chunk and refaulted when their blocks are handed out,
+     *        INTRUSIVE chunks are tracked by bitmap until then, skipped unless Warm::LAZY, and for heap and SHARED
+     *
+     * @param [in] budget OPTIONAL: max discarded bytes, checked per run of pages
+     * @param [in] lazy   OPTIONAL: MADV_FREE instead of MADV_DONTNEED, reclaimed by kernel under pressure only
+     * @return discarded bytes
+     */
+    size_t scavenge(size_t budget = ~size_t(0), bool lazy = false);
+
+public:
+    /**
+     * @brief syscall: keep unused chunks between watermarks, generated and prefaulted ahead of acquire
+     * @note  call on idle, or periodically from a refill thread with the allocator lock, e.g. Shared
+     *
+     * @param [in] low  min unused chunk count, generated and prefaulted if less
+     * @param [in] high max unused chunk count, destroyed if more
+     * @return generated or destroyed chunks count
+     */
+    size_t maintain(size_t low, size_t high);
 
 public:
     /**
-     * @brief change all chunks to empty state
-     * @throw when chunk in use on debug
+     * @brief change all chunks to unused state, destructors are not called
+     * @note  pending remote frees are dropped
      */
     void reset();
 
+public:
+    /**
+     * @brief visit live blocks in address order, by chunk bitmaps, next block is prefetched
+     * @note  do not acquire or release in fn, free list chunks are converted to bitmap until reused
+     *
+     * @tparam T  type of block
+     * @param [in] fn callable as fn(T*)
+     */
+    template<typename T = void, typename Fn> void for_each_live(Fn&& fn);
+
+public:
+    /**
+     * @brief syscall: evacuate live blocks of the sparsest partial chunks into the densest, and destroy emptied chunks
+     * @note  incremental, call repeatedly in idle slices, WHOLE is not supported
+     *
+     * @tparam T type of block
+     * @param [in] budget max moved blocks count in this call
+     * @param [in] fn     callable as fn(T* from, T* to), moves object and updates its references
+     * @return moved blocks count
+     */
+    template<typename T = void, typename Fn> size_t compact(size_t budget, Fn&& fn);
+
+public:
+    /**
+     * @brief call destructors of live blocks in address order, then reset
+     *
+     * @tparam T type of block, void does not call destructor
+     */
+    template<typename T = void> void destroy_all();
+
 public:
     /**
      * @brief get remaind block count
+     * @note  SHARED: counted from chunk usage
      */
     size_t usable();
 
+public:
+    /**
+     * @brief set warm-start mode, and apply to all chunks already generated
+     * @note  call before reserve to prefault reserved chunks in generate
+     *
+     * @param [in] mode LAZY unlocks chunks locked before
+     * @return false if some chunks failed to prefault or lock, those are not counted by ready
+     */
+    bool warm(Warm mode);
+
+public:
+    /**
+     * @brief get guaranteed fault-free block count, remained blocks in warmed chunks
+     */
+    size_t ready() const;
+
+public:
+    /**
+     * @brief latency histograms of this size class on the calling thread
+     * @note  recorded only if MEM_LATENCY is not 0
+     */
+    static Latency& latency() noexcept;
+
 private:
     Stack full;    //!< chunks using block is 0
     Stack empty;   //!< chunks using block is full
     Stack partial; //!< chunks using block is ?
 
 private:
-    Chunk* current = nullptr; //!< using chunk
-    size_t counter = 0;       //!< usable block counter
+    std::conditional_t<CONCURRENT, Hot, core::Offset<Chunk>> current; //!< using chunk
+    size_t counter = 0; //!< usable block counter, SHARED: capacity counted in usable
+
+private:
+    core::Spin latch; //!< SHARED: chunk lists and switching current
+
+private:
+    core::Offset<Heap> heap;              //!< chunk source, null is syscall
+    Backend*           backend = nullptr; //!< chunk source if not heap, null is syscall
+
+private:
+    Tag* tag = nullptr; //!< budget charged per block, see bind
+
+private:
+    Registry::Entry entry = {}; //!< owner is nullptr if not registered
+
+private:
+    uint32_t home = mark(); //!< owner thread token, size-free release from others is queued as remote free
+
+private:
+    //! @brief calling thread token, unique while process, not reused by new threads like thread local addresses
+    static uint32_t mark() noexcept;
+
+private:
+    std::atomic<Registry::Deferred*> deferred{ nullptr }; //!< release_deferred queue, lock-free stack
+    uint32_t        seen  = 0;  //!< last Registry::pressure
+
+private:
+    //! @brief charge a block to tag, false if over budget
+    bool charge() noexcept;
+
+private:
+    //! @brief refund blocks to tag
+    void refund(size_t cnt = 1) noexcept;
+
+private:
+    //! @brief visit chunks having live blocks in address order, WHOLE: visit live blocks
+    template<typename Fn> void sweep(Fn&& fn);
+
+private:
+    //! @brief register to Registry
+    void enroll() noexcept;
+
+private:
+    //! @brief reclaim allocators of this thread and scavenge if Registry raised pressure, release and syscall path
+    void relieve() noexcept;
+
+private:
+    Warm mode = Warm::LAZY; //!< chunk preparation
+    bool cold = false;      //!< WHOLE: some cached block is not warmed
+
+private:
+    //! @brief prefault or lock by mode, and set chunk flag
+    bool heat(Chunk*) noexcept;
+
+public:
+    //! @brief size class descriptor for Pagemap, identifies blocks of this type
+    static const Pagemap::Class CLASS;
+
+private:
+    //! @brief SHARED: reserve a block of current and claim its bit, lock only to switch current
+    void* grab() noexcept;
+
+private:
+    //! @brief SHARED: vacate a block, full chunk parked in empty returns to partial
+    void drop(Chunk*, size_t) noexcept;
+
+private:
+    //! @brief SHARED: push out of current to empty or partial by usage, latch is locked
+    void park(Chunk*) noexcept;
+
+private:
+    //! @brief slow path of acquire_aligned, claim a block aligned over ALIGN
+    void* seek(size_t align) noexcept;
+
+private:
+    //! @brief slow path of acquire_near, claim the free block nearest to hint in its chunk
+    void* nearby(const void* hint) noexcept;
+
+private:
+    //! @brief take a free block index of chunk, by tracking
+    static size_t claim(Chunk*) noexcept;
+
+private:
+    //! @brief return a block index to chunk, by tracking
+    static void vacate(Chunk*, size_t) noexcept;
+
+private:
+    //! @brief scavenge unit, page and at least CHUNK / 64, a bit of meta.idle
+    static size_t grain() noexcept;
+
+private:
+    //! @brief clear discarded mark of pages under block, refaulted by first write
+    static void touch(Chunk*, size_t) noexcept;
+
+private:
+    //! @brief INTRUSIVE: read link of free block at byte offset, HARDEN: decode and validate
+    static uint32_t follow(const Chunk*, uint32_t) noexcept;
+
+private:
+    //! @brief INTRUSIVE: live blocks of free list tracked chunk to bitmap, chunk is not changed
+    static void census(const Chunk*, typename Chunk::State&) noexcept;
+
+private:
+    //! @brief INTRUSIVE: build bitmap from free list, chunk is tracked by bitmap until threaded
+    static void map(Chunk*) noexcept;
+
+private:
+    //! @brief INTRUSIVE: rebuild free list from bitmap
+    static void thread(Chunk*) noexcept;
+
+private:
+    //! @brief queue block to chunk of other allocator, lock-free
+    static void remote(Chunk*, void*) noexcept;
+
+private:
+    //! @brief reclaim remote frees of chunk, return reclaimed count
+    size_t drain(Chunk*) noexcept;
+
+private:
+    //! @brief slow path: drain chunks having remote frees
+    void collect() noexcept;
+
+private:
+    //! @brief slow path: take a chunk abandoned by exited allocator
+    Chunk* adopt() noexcept;
+
+private:
+    //! @brief push to list by usage
+    void settle(Chunk*) noexcept;
+
+private:
+    //! @brief set Pagemap owner of chunk
+    static void own(Chunk*, Allocator*) noexcept;
+
+private:
+    static List       orphans; //!< abandoned chunks in use
+    static Table      table;   //!< chunk ids
+    static core::Spin guard;   //!< orphans and table lock
 
 private:
     //! @brief syscall allocate
@@ -1,247 +1,1926 @@
-#ifndef MEM_Allocator_HPP
+#ifndef MEM_ALLOCATOR_HPP
 #    include "allocator.hpp"
 #endif
 
-template<size_t N, bool BASE> struct Allocator<N, BASE>::Meta {
-    size_t     used  = 0;
-    Allocator* outer = 0;
-    Chunk*     next  = nullptr;
-    Chunk*     prev  = nullptr;
+template<size_t N, typename P, bool BASE> struct Allocator<N, P, BASE>::Meta {
+    //! @brief chunk state flags
+    enum : uint32_t {
+        WARM    = 1 << 0, //!< pages are populated
+        LOCKED  = 1 << 1, //!< pages are locked
+        SAMPLED = 1 << 2, //!< has blocks recorded by profiler
+        MAPPED  = 1 << 3, //!< INTRUSIVE: tracked by bitmap until threaded
+        PARKED  = 1 << 4, //!< SHARED: in empty, returned to partial by release
+    };
+
+    std::conditional_t<CONCURRENT, std::atomic<uint32_t>, uint32_t> used{ 0 }; //!< SHARED: reserved before bit is claimed
+    uint32_t                flag = 0;
+    std::atomic<void*>      remote{ nullptr }; //!< blocks freed by other allocators, linked in block
+    uint32_t                id = 0;            //!< table index, 0 is not registered
+    uint32_t                free = 0;          //!< INTRUSIVE: free list head, byte offset in chunk, 0 is none
+    uint32_t                bump = 0;          //!< INTRUSIVE: blocks from bump are never handed out
+    uint32_t                key  = 0;          //!< INTRUSIVE: link encoding key, HARDEN
+    std::atomic<uint32_t>   home{ 0 };         //!< owner thread token, 0 is abandoned, read by size-free release
+    uint64_t                idle = 0;          //!< pages discarded by scavenge, bit per grain()
+    core::Offset<Allocator> outer;
+    core::Offset<Chunk>     next;
+    core::Offset<Chunk>     prev;
+};
+
+template<size_t N, typename P, bool BASE> struct Allocator<N, P, BASE>::Chunk {
+    /**
+     * @brief block count that fits with the header padded to ALIGN
+     * @return the block total bits / data + flag bits, reduced until header padding fits
+     */
+    static constexpr size_t capacity() {
+        size_t cnt = (CHUNK - sizeof(Meta)) * 8 / (BLOCK * 8 + 1); // upper bound
+        while(global::num_align(sizeof(Meta) + words(cnt) * sizeof(uint64_t), ALIGN) + cnt * BLOCK > CHUNK) {
+            --cnt; // padding overflow
+        }
+        return cnt;
+    }
+
+    //! @brief state words of block count, SHARED has summary words
+    static constexpr size_t words(size_t cnt) { return (cnt + 63) / 64 + (CONCURRENT ? ((cnt + 63) / 64 + 63) / 64 : 0); }
+
+    //! @brief block count
+    static constexpr size_t COUNT = WHOLE ? 1 : capacity();
+
+    //! @brief object count to byte, divied to sizeof(uint_64), and round up, SHARED: claimed by atomic
+    using State = std::conditional_t<CONCURRENT, core::AtomicMask<COUNT>, core::Mask<(COUNT + 63) / 64>>;
+
+    //! @brief [ meta | state | PADDING | data ], data begins at ALIGN boundary, WHOLE has no header
+    static constexpr size_t OFFSET  = WHOLE ? 0 : global::num_align(sizeof(Meta) + sizeof(State), ALIGN);
+    static constexpr size_t PADDING = WHOLE ? 0 : OFFSET - (sizeof(Meta) + sizeof(State));
+
+    //! @brief size check
+    static_assert(WHOLE || (sizeof(Meta) + sizeof(State) + PADDING + BLOCK * COUNT) <= CHUNK);
+
+    Meta    meta;
+    State   state;
+    uint8_t data[CHUNK - sizeof(meta) - sizeof(state)];
 };
 
-template<size_t N, bool BASE> struct Allocator<N, BASE>::Chunk {
-    //! @brief the block total bits / data + flag bits
-    static constexpr size_t COUNT = WHOLE ? 1 : (CHUNK - sizeof(Meta)) * 8 / (BLOCK * 8 + 1);
+template<size_t N, typename P, bool BASE> Allocator<N, P, BASE>::Allocator() {
+    enroll();
+}
+
+template<size_t N, typename P, bool BASE> Allocator<N, P, BASE>::Allocator(Heap* heap): heap(heap) {
+    static_assert(!WHOLE);      // chunk vector is not in heap
+    static_assert(!CONCURRENT); // latch of other process
+
+    if(!heap) {
+        enroll(); // heap allocator may be used by other process
+    }
+}
+
+template<size_t N, typename P, bool BASE> Allocator<N, P, BASE>::Allocator(Backend* backend): backend(backend) {
+    enroll();
+}
+
+template<size_t N, typename P, bool BASE>::Allocator<N, P, BASE>::~Allocator() {
+    if(entry.owner) {
+        Registry::erase(&entry);
+    }
+    drain_deferred(); // not reaped after erase
+
+    // abandon chunks in use, blocks may be referenced by other threads
+    if constexpr(!WHOLE && REMOTE) {
+        if(!heap) {
+            if(current) {
+                settle(current);
+                current = nullptr;
+            }
+
+            Stack* list[2] = { &empty, &partial };
+            for(int i = 0; i < 2; ++i) {
+                while(Chunk* chunk = list[i]->pop()) {
+                    drain(chunk);
+                    if(chunk->meta.used == 0) {
+                        full.push(chunk); // destroy below
+                        continue;
+                    }
+                    refund(chunk->meta.used); // charged to adopter
+                    chunk->meta.home.store(0, std::memory_order_relaxed);
+                    chunk->meta.outer = nullptr;
+                    own(chunk, nullptr);
+
+                    std::lock_guard<core::Spin> lock(guard);
+                    orphans.push(chunk);
+                }
+            }
+        }
+    }
+
+    Stack* list[3] = { &empty, &full, &partial };
+    for(int i = 0; i < 3; ++i) {
+        Stack* stack = list[i];
+
+        Chunk* curr = stack->pop(); // pop curr
+        while(curr != nullptr) {
+            Chunk* next = stack->pop(); // pop next
+            if constexpr(WHOLE) {
+                refund(stack == &empty ? 1 : 0); // live block
+            }
+            else refund(curr->meta.used);
+            destroy(curr); // delete curr
+            curr = next;   // curr to next
+        }
+    }
+    if(current) {
+        refund(current->meta.used);
+        destroy(current);
+    }
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U, typename... Args> U* Allocator<N, P, BASE>::acquire(Args&&... in) noexcept {
+    if constexpr(N == 0) {
+        return nullptr;
+    }
+
+    // over-aligned type, use acquire_aligned
+    if constexpr(std::is_same_v<U, void> == false) {
+        static_assert(alignof(U) <= ALIGN);
+    }
+
+    // budget, fails fast before any path
+    if(!charge()) {
+        return nullptr;
+    }
+
+    Latency::Probe probe(STATS ? &latency : nullptr, Latency::Op::ACQUIRE);
+
+    // huge pages
+    if constexpr (WHOLE) {
+        Chunk* temp = full.pop(); // pop
+        probe.tag(Latency::Path::RECYCLE);
+        if (!temp) {
+            probe.tag(Latency::Path::SYSCALL);
+            relieve();         // idle chunks of this thread go first
+            temp = generate(); // alloc
+            if(!temp) {
+                refund();
+                return nullptr; // failed
+            }
+        }
+        if(!empty.push(temp)) {
+            destroy(temp); // vector growth failed
+            refund();
+            return nullptr;
+        }
+        Pagemap::find(temp)->slot = empty.top; // index for release
+        --counter;                             // count
+        if constexpr(STATS) {
+            if(Profiler::tick(BLOCK)) {
+                Profiler::sample(temp, BLOCK); // rare
+            }
+        }
+        if constexpr(std::is_same_v<U, void>) {
+            return temp; // return
+        }
+        else return CXX_LAUNDER(reinterpret_cast<U*>(temp)); // return with launder
+    }
+
+    // shared chunk
+    if constexpr(CONCURRENT) {
+        void* out = grab();
+        if(!out) {
+            refund();
+            return nullptr; // failed
+        }
+        if constexpr(std::is_same_v<U, void> == false) {
+            if constexpr(sizeof...(Args) != 0) {
+                return new(out) U(std::forward<Args>(in)...);
+            }
+            else return new(out) U();
+        }
+        else return out;
+    }
+
+    // check block
+    if(!current) {
+        probe.tag(Latency::Path::RECYCLE);
+        current = full.pop(); // first: recycle
+        if(!current) {
+            current = partial.pop(); // second: recycle
+            if(!current) {
+                collect(); // third: remote frees
+                current = full.pop();
+                if(!current) {
+                    current = partial.pop();
+                }
+            }
+            if(!current) {
+                current = adopt(); // fourth: abandoned
+            }
+            if(!current) {
+                probe.tag(Latency::Path::SYSCALL);
+                relieve();            // idle chunks of this thread go first
+                current = generate(); // last: alloc
+                if(!current) {
+                    refund();
+                    return nullptr; // failed
+                }
+            }
+        }
+    }
+
+    // check state
+    size_t index = claim(current);
+
+    // return
+    void* out = reinterpret_cast<uint8_t*>(current.get()) + Chunk::OFFSET + index * BLOCK;
+
+    // sampling, a decrement when not due
+    if constexpr(STATS) {
+        if(Profiler::tick(BLOCK) && Profiler::sample(out, BLOCK)) {
+            current->meta.flag |= Meta::SAMPLED;
+        }
+    }
+
+    // get meta, and MAX to index
+    // usage partial -> empty
+    if(++current->meta.used > Chunk::COUNT - 1) {
+        probe.tag(Latency::Path::SWITCH);
+        empty.push(current);
+        current = nullptr; // prepare next chunk
+    }
+    --counter; // count
+
+    // call constructor
+    if constexpr(std::is_same_v<U, void> == false) {
+        if constexpr(sizeof...(Args) != 0) {
+            return new(out) U(std::forward<Args>(in)...);
+        }
+        else return new(out) U();
+        return CXX_LAUNDER(static_cast<U*>(out));
+    }
+    else return out;
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U, typename... Args> U* Allocator<N, P, BASE>::acquire_aligned(size_t align, Args&&... in) noexcept {
+    if constexpr(std::is_same_v<U, void> == false) {
+        if(align < alignof(U)) {
+            align = alignof(U); // at least type alignment
+        }
+    }
+
+    // natural alignment, never for over-aligned type
+    if constexpr(alignof(std::conditional_t<std::is_same_v<U, void>, char, U>) <= ALIGN) {
+        if(align <= ALIGN) {
+            return acquire<U>(std::forward<Args>(in)...);
+        }
+    }
+
+    // invalid alignment
+    if(!global::bit_aligned(align) || align > global::PAL_PAGE) {
+        return nullptr;
+    }
+
+    if(!charge()) {
+        return nullptr; // over budget
+    }
+    void* out = seek(align);
+    if(!out) {
+        refund();
+        return nullptr; // failed
+    }
+
+    // call constructor
+    if constexpr(std::is_same_v<U, void> == false) {
+        if constexpr(sizeof...(Args) != 0) {
+            return new(out) U(std::forward<Args>(in)...);
+        }
+        else return new(out) U();
+    }
+    else return out;
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U, typename... Args> U* Allocator<N, P, BASE>::acquire_near(const void* hint, Args&&... in) noexcept {
+    if(!hint) {
+        return acquire<U>(std::forward<Args>(in)...);
+    }
+    if(!charge()) {
+        return nullptr; // over budget
+    }
+    void* out = nearby(hint);
+    if(!out) {
+        refund();
+        return acquire<U>(std::forward<Args>(in)...); // fallback
+    }
+
+    // call constructor
+    if constexpr(std::is_same_v<U, void> == false) {
+        if constexpr(sizeof...(Args) != 0) {
+            return new(out) U(std::forward<Args>(in)...);
+        }
+        else return new(out) U();
+    }
+    else return out;
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U> void Allocator<N, P, BASE>::release(U* in) {
+    // call destrcutor
+    if constexpr(std::is_same_v<U, void> == false) {
+        in->~U();
+    }
+
+    if constexpr(N == 0) return;
+
+    Latency::Probe probe(STATS ? &latency : nullptr, Latency::Op::RELEASE);
+
+    // huge pages
+    if constexpr (WHOLE) {
+        Chunk*          chunk = reinterpret_cast<Chunk*>(const_cast<std::remove_cv_t<U>*>(in));
+        Pagemap::Entry* entry = Pagemap::find(chunk);
+        // check
+        if(!entry || entry->owner != this || entry->base != chunk || entry->slot == 0) {
+            std::abort(); // not found
+        }
+        // swap and delete, without search
+        Chunk* moved = empty.remove(entry->slot - 1);
+        if(moved) {
+            Pagemap::find(moved)->slot = entry->slot;
+        }
+        entry->slot = 0;
+        if(STATS && Profiler::live()) {
+            Profiler::forget(chunk);
+        }
+        full.push(chunk); // OK
+        probe.tag(Latency::Path::SWITCH);
+        ++counter;
+        refund();
+        relieve();
+    }
+    else {
+        // get chunk info
+        Chunk*    chunk;
+        ptrdiff_t index;
+
+        static constexpr size_t MASK = CHUNK - 1; // e.g. if CHUNK 65536 then operate by 0xFFFF
+
+        // find chunk begin address
+        chunk = reinterpret_cast<Chunk*>(uintptr_t(in) & ~MASK); // known UB but safe in practice
+
+        // calculate index of the block within the chunk
+        index = ((uintptr_t(in) - Chunk::OFFSET) & MASK) / BLOCK; // optimize by compiler
+
+        // other allocator, or abandoned, outer may be rewritten by adopter but never to this
+        if(chunk->meta.outer != this) {
+            const Pagemap::Entry* entry = heap ? nullptr : Pagemap::find(chunk);
+            if(!entry || entry->cls != &CLASS) {
+                std::abort(); // other size or heap
+            }
+            if constexpr(!REMOTE) {
+                std::abort(); // single thread policy
+            }
+            remote(chunk, in);
+            return;
+        }
+
+        // any thread
+        if constexpr(CONCURRENT) {
+            drop(chunk, index);
+            refund();
+            return;
+        }
+
+        // sampled chunk only
+        if(chunk->meta.flag & Meta::SAMPLED) {
+            Profiler::forget(in);
+        }
+
+        // set state and check
+        vacate(chunk, index);
+        if(chunk != current) {
+            // usage empty -> partial
+            if(chunk->meta.used == Chunk::COUNT) {
+                probe.tag(Latency::Path::SWITCH);
+                empty.remove(chunk);
+                partial.push(chunk);
+            }
+            // usage partial -> full
+            if(chunk->meta.used == 1) {
+                probe.tag(Latency::Path::SWITCH);
+                partial.remove(chunk);
+                full.push(chunk);
+            }
+        }
+        --chunk->meta.used; // decount
+        ++counter;
+        refund();
+
+        // idle chunk, chance to shrink under pressure
+        if(chunk->meta.used == 0) {
+            chunk->meta.flag &= ~uint32_t(Meta::SAMPLED); // all forgotten
+            if constexpr(INTRUSIVE) {
+                thread(chunk); // fresh list
+            }
+            relieve();
+        }
+    }
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U> void Allocator<N, P, BASE>::release(U* const* in, size_t cnt) {
+    if constexpr(WHOLE || CONCURRENT || N == 0) {
+        for(size_t i = 0; i < cnt; ++i) {
+            release(in[i]); // block is the chunk, or claimed without lock
+        }
+    }
+    else {
+        static constexpr size_t MASK = CHUNK - 1;
+
+        for(size_t i = 0; i < cnt;) {
+            Chunk* chunk = reinterpret_cast<Chunk*>(uintptr_t(in[i]) & ~MASK);
+            if(chunk->meta.outer != this) {
+                release(in[i++]); // other allocator, checked and queued as remote free
+                continue;
+            }
+
+            // run of blocks in the same chunk
+            size_t run = 0;
+            for(; i < cnt && (uintptr_t(in[i]) & ~MASK) == uintptr_t(chunk); ++i, ++run) {
+                if constexpr(std::is_same_v<U, void> == false) {
+                    in[i]->~U();
+                }
+                if(chunk->meta.flag & Meta::SAMPLED) {
+                    Profiler::forget(in[i]);
+                }
+                vacate(chunk, ((uintptr_t(in[i]) - Chunk::OFFSET) & MASK) / BLOCK);
+            }
+
+            // lists and counters once per run
+            if(chunk != current) {
+                Stack* from = chunk->meta.used == Chunk::COUNT ? &empty : &partial;
+                Stack* to   = chunk->meta.used == run ? &full : &partial;
+                if(from != to) {
+                    from->remove(chunk);
+                    to->push(chunk);
+                }
+            }
+            chunk->meta.used -= uint32_t(run);
+            counter          += run;
+            refund(run);
+
+            // idle chunk, chance to shrink under pressure
+            if(chunk->meta.used == 0) {
+                chunk->meta.flag &= ~uint32_t(Meta::SAMPLED); // all forgotten
+                if constexpr(INTRUSIVE) {
+                    thread(chunk); // fresh list
+                }
+                relieve();
+            }
+        }
+    }
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U> void Allocator<N, P, BASE>::release_deferred(U* in) {
+    // process local queue, not restored with heap
+    Registry::Deferred* node = heap ? nullptr : static_cast<Registry::Deferred*>(std::malloc(sizeof(Registry::Deferred)));
+    if(!node) {
+        release(in); // inline
+        return;
+    }
+
+    node->ptr = const_cast<std::remove_cv_t<U>*>(in);
+    if constexpr(std::is_same_v<U, void> || std::is_trivially_destructible_v<U>) {
+        node->dtor = nullptr;
+    }
+    else node->dtor = [](void* ptr) { static_cast<U*>(ptr)->~U(); };
+    node->free = [](void* ptr) {
+        if constexpr(!WHOLE) {
+            remote(reinterpret_cast<Chunk*>(uintptr_t(ptr) & ~(CHUNK - 1)), ptr);
+        }
+    };
+
+    // push
+    Registry::Deferred* head = deferred.load(std::memory_order_relaxed);
+    do {
+        node->next = head;
+    } while(!deferred.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::drain_deferred(size_t max) {
+    if(!deferred.load(std::memory_order_relaxed)) {
+        return 0; // none
+    }
+
+    // pop all, oldest first
+    Registry::Deferred* list  = deferred.exchange(nullptr, std::memory_order_acquire);
+    Registry::Deferred* order = nullptr;
+    while(list) {
+        Registry::Deferred* next = list->next;
+        list->next               = order;
+        order                    = list;
+        list                     = next;
+    }
+
+    size_t out = 0;
+    while(order && out < max) {
+        Registry::Deferred* next = order->next;
+        if(order->dtor) {
+            order->dtor(order->ptr);
+        }
+        release(order->ptr); // local, or remote if other chunk
+        std::free(order);
+        order = next;
+        ++out;
+    }
+
+    // requeue rest
+    while(order) {
+        Registry::Deferred* next = order->next;
+        Registry::Deferred* head = deferred.load(std::memory_order_relaxed);
+        do {
+            order->next = head;
+        } while(!deferred.compare_exchange_weak(head, order, std::memory_order_release, std::memory_order_relaxed));
+        order = next;
+    }
+    return out;
+}
+
+template<size_t N, typename P, bool BASE> bool Allocator<N, P, BASE>::check(const void* in) const noexcept {
+    if constexpr(N == 0) {
+        return false;
+    }
+
+    // registered chunk
+    if(!heap) {
+        const Pagemap::Entry* entry = Pagemap::find(in);
+        if(!entry || entry->owner != this) {
+            return false; // not in this pool
+        }
+        if constexpr(WHOLE) {
+            return entry->base == in && entry->slot != 0; // in use
+        }
+    }
+
+    if constexpr(!WHOLE) {
+        static constexpr size_t MASK = CHUNK - 1;
+
+        const Chunk* chunk = reinterpret_cast<const Chunk*>(uintptr_t(in) & ~MASK);
+        const size_t pos   = uintptr_t(in) & MASK;
+
+        // check pool and block boundary
+        if(chunk->meta.outer != this || pos < Chunk::OFFSET || (pos - Chunk::OFFSET) % BLOCK != 0) {
+            return false;
+        }
+
+        size_t index = (pos - Chunk::OFFSET) / BLOCK;
+        if constexpr(INTRUSIVE) {
+            if(!(chunk->meta.flag & Meta::MAPPED)) {
+                if(index >= chunk->meta.bump) {
+                    return false; // never handed out
+                }
+                for(uint32_t off = chunk->meta.free; off; off = follow(chunk, off)) {
+                    if(off == pos) return false; // in free list
+                }
+                return true;
+            }
+        }
+        return index < Chunk::COUNT && chunk->state.check(index);
+    }
+    return false;
+}
+
+template<size_t N, typename P, bool BASE> const Pagemap::Class Allocator<N, P, BASE>::CLASS = {
+    BLOCK,
+    CHUNK,
+    [](void* owner, void* ptr) {
+        Allocator* self = static_cast<Allocator*>(owner);
+        if constexpr(CONCURRENT) {
+            self->release(ptr); // thread safe, chunks live with owner
+        }
+        else if constexpr(WHOLE) {
+            if(!self || self->home != mark()) {
+                std::abort(); // other thread, blocks live with owner
+            }
+            self->release(ptr);
+        }
+        else {
+            // live block keeps chunk, owner is not touched by other threads: it may be destroyed meanwhile
+            Chunk* chunk = reinterpret_cast<Chunk*>(uintptr_t(ptr) & ~(CHUNK - 1));
+            if(chunk->meta.home.load(std::memory_order_relaxed) == mark()) {
+                self->release(ptr); // owner thread
+            }
+            else if constexpr(REMOTE) {
+                remote(chunk, ptr); // other thread, or abandoned
+            }
+            else std::abort(); // other thread of SINGLE policy
+        }
+    },
+    [](void* owner, const void* ptr) { return owner && static_cast<const Allocator*>(owner)->check(ptr); },
+};
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::bind(Tag* in) noexcept {
+    tag = in;
+}
+
+template<size_t N, typename P, bool BASE> bool Allocator<N, P, BASE>::charge() noexcept {
+    return !tag || tag->charge(BLOCK);
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::refund(size_t cnt) noexcept {
+    if(tag && cnt) {
+        tag->refund(cnt * BLOCK);
+    }
+}
+
+template<size_t N, typename P, bool BASE> uint32_t Allocator<N, P, BASE>::mark() noexcept {
+    static std::atomic<uint32_t> next{ 1 }; // 0 is none
+    static thread_local const uint32_t token = next.fetch_add(1, std::memory_order_relaxed);
+    return token;
+}
+
+template<size_t N, typename P, bool BASE> typename Allocator<N, P, BASE>::List Allocator<N, P, BASE>::orphans;
+
+template<size_t N, typename P, bool BASE> typename Allocator<N, P, BASE>::Table Allocator<N, P, BASE>::table;
+
+template<size_t N, typename P, bool BASE> core::Spin Allocator<N, P, BASE>::guard;
+
+template<size_t N, typename P, bool BASE> uint32_t Allocator<N, P, BASE>::locate(const void* in) noexcept {
+    if constexpr(WHOLE || N == 0) {
+        return 0;
+    }
+    else {
+        static constexpr size_t MASK = CHUNK - 1;
+
+        const Chunk* chunk = reinterpret_cast<const Chunk*>(uintptr_t(in) & ~MASK);
+        const size_t index = ((uintptr_t(in) - Chunk::OFFSET) & MASK) / BLOCK;
+        return chunk->meta.id ? uint32_t((chunk->meta.id << SLOT) | index) : 0;
+    }
+}
+
+template<size_t N, typename P, bool BASE> void* Allocator<N, P, BASE>::place(uint32_t loc) noexcept {
+    if constexpr(WHOLE || N == 0) {
+        return nullptr;
+    }
+    else {
+        const size_t id = loc >> SLOT;
+        if(id >= IDS || !table.chunk) {
+            return nullptr; // invalid
+        }
+        Chunk* chunk = table.chunk[id].load(std::memory_order_acquire);
+        return chunk ? reinterpret_cast<uint8_t*>(chunk) + Chunk::OFFSET + (loc & ((1u << SLOT) - 1)) * BLOCK : nullptr;
+    }
+}
+
+template<size_t N, typename P, bool BASE> uint8_t* Allocator<N, P, BASE>::generation(uint32_t loc, bool make) noexcept {
+    if constexpr(WHOLE || N == 0) {
+        return nullptr;
+    }
+    else {
+        const size_t id = loc >> SLOT;
+        if(id >= IDS || !table.chunk) {
+            return nullptr; // invalid
+        }
+
+        uint8_t* gen = table.gen[id].load(std::memory_order_acquire);
+        if(!gen && make) {
+            std::lock_guard<core::Spin> lock(guard);
+
+            gen = table.gen[id].load(std::memory_order_relaxed);
+            if(!gen) {
+                gen = static_cast<uint8_t*>(std::calloc(Chunk::COUNT, 1)); // kept while process
+                table.gen[id].store(gen, std::memory_order_release);
+            }
+        }
+        return gen ? gen + (loc & ((1u << SLOT) - 1)) : nullptr;
+    }
+}
+
+template<size_t N, typename P, bool BASE> void* Allocator<N, P, BASE>::nearby(const void* hint) noexcept {
+    if constexpr(WHOLE || N == 0 || CONCURRENT) {
+        return nullptr; // 1 block per chunk, or shared chunk
+    }
+    else {
+        static constexpr size_t MASK  = CHUNK - 1;
+        static constexpr size_t WORDS = (Chunk::COUNT + 63) / 64;
+        static constexpr size_t TAIL  = Chunk::COUNT - (WORDS - 1) * 64; // valid bits of last word
+
+        Chunk* chunk = reinterpret_cast<Chunk*>(uintptr_t(hint) & ~MASK);
+
+        // chunk of this allocator
+        if(!heap) {
+            const Pagemap::Entry* entry = Pagemap::find(hint);
+            if(!entry || entry->owner != this || entry->base != chunk) {
+                return nullptr;
+            }
+        }
+        if(chunk->meta.outer != this || chunk->meta.used >= Chunk::COUNT) {
+            return nullptr; // other or full
+        }
+
+        Stack* from = chunk == current ? nullptr : (chunk->meta.used == 0 ? &full : &partial);
+
+        size_t index;
+        if constexpr(INTRUSIVE) {
+            index = claim(chunk); // LIFO head, or bump
+        }
+        else {
+            // free bits of word, bits over COUNT are not free
+            auto vacant = [chunk](size_t w) -> uint64_t {
+                const uint64_t bits = ~chunk->state.word(w);
+                return w == WORDS - 1 && TAIL < 64 ? bits & ((uint64_t(1) << TAIL) - 1) : bits;
+            };
+
+            const size_t at  = ((uintptr_t(hint) & MASK) - Chunk::OFFSET) / BLOCK;
+            const size_t w   = at >> 6;
+            const size_t bit = at & 63;
+
+            // same word: nearest by distance
+            index = size_t(-1);
+            if(const uint64_t bits = vacant(w)) {
+                const uint64_t up   = bits >> bit;                  // bit and above
+                const uint64_t down = bit ? bits << (64 - bit) : 0; // below bit
+                const size_t   a    = up ? size_t(global::bit_ctz(up)) : 64;
+                const size_t   b    = down ? size_t(global::bit_clz(down)) + 1 : 64;
+                index               = (w << 6) + (a <= b ? bit + a : bit - b);
+            }
+
+            // neighbor words, closer side first
+            for(size_t d = 1; index == size_t(-1) && d < WORDS; ++d) {
+                const uint64_t above = w + d < WORDS ? vacant(w + d) : 0;
+                const uint64_t below = w >= d ? vacant(w - d) : 0;
+                if(!above && !below) continue;
+
+                const size_t high = above ? ((w + d) << 6) + size_t(global::bit_ctz(above)) : size_t(-1);
+                const size_t low  = below ? ((w - d) << 6) + 63 - size_t(global::bit_clz(below)) : size_t(-1);
+                if(low == size_t(-1) || (high != size_t(-1) && high - at <= at - low)) {
+                    index = high;
+                }
+                else index = low;
+            }
+            if(index == size_t(-1)) {
+                return nullptr; // unreachable, used is less than COUNT
+            }
+            chunk->state.on(index);
+            if(chunk->meta.idle) {
+                touch(chunk, index);
+            }
+        }
+        ++chunk->meta.used;
+        --counter;
+
+        void* out = reinterpret_cast<uint8_t*>(chunk) + Chunk::OFFSET + index * BLOCK;
+        if constexpr(STATS) {
+            if(Profiler::tick(BLOCK) && Profiler::sample(out, BLOCK)) {
+                chunk->meta.flag |= Meta::SAMPLED;
+            }
+        }
+
+        // update chunk state
+        if(chunk->meta.used == Chunk::COUNT) {
+            if(from) {
+                from->remove(chunk);
+            }
+            else current = nullptr;
+            empty.push(chunk);
+        }
+        else if(from == &full) {
+            full.remove(chunk);
+            partial.push(chunk);
+        }
+        return out;
+    }
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::claim(Chunk* chunk) noexcept {
+    size_t index;
+    if constexpr(INTRUSIVE) {
+        if((chunk->meta.flag & Meta::MAPPED) && !chunk->meta.idle) {
+            thread(chunk); // converted by iteration
+        }
+
+        const uint32_t off = chunk->meta.free;
+        if(chunk->meta.flag & Meta::MAPPED) {
+            index = chunk->state.next(); // discarded free blocks have no link, bitmap until refaulted
+            chunk->state.on(index);
+        }
+        else if(off) {
+            chunk->meta.free = follow(chunk, off); // first: free list, LIFO
+            index            = (off - Chunk::OFFSET) / BLOCK;
+        }
+        else index = chunk->meta.bump++; // second: never used
+    }
+    else {
+        index = chunk->state.next();
+        chunk->state.on(index);
+    }
+
+    if(chunk->meta.idle) {
+        touch(chunk, index);
+    }
+    return index;
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::grain() noexcept {
+    static const size_t out = global::pal_page() > CHUNK / 64 ? global::pal_page() : CHUNK / 64;
+    return out;
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::touch(Chunk* chunk, size_t index) noexcept {
+    const size_t unit = grain();
+    const size_t lo   = (Chunk::OFFSET + index * BLOCK) / unit;
+    const size_t hi   = (Chunk::OFFSET + index * BLOCK + BLOCK - 1) / unit;
+
+    chunk->meta.idle &= ~(((uint64_t(2) << (hi - lo)) - 1) << lo); // refaulted by first write
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::vacate(Chunk* chunk, size_t index) noexcept {
+    if constexpr(INTRUSIVE) {
+        if(chunk->meta.flag & Meta::MAPPED) {
+            chunk->state.off(index);
+            return;
+        }
+
+        const uint32_t off  = uint32_t(Chunk::OFFSET + index * BLOCK);
+        const uint32_t head = chunk->meta.free;
+        if constexpr(HARDEN) {
+            if(off == head || index >= chunk->meta.bump) {
+                std::abort(); // double free, or never handed out
+            }
+        }
+
+        uint32_t link = head;
+        if constexpr(HARDEN) {
+            link ^= chunk->meta.key ^ (off * 0x9E3779B1u); // by location
+        }
+        std::memcpy(reinterpret_cast<uint8_t*>(chunk) + off, &link, sizeof(link));
+        chunk->meta.free = off;
+    }
+    else chunk->state.off(index);
+}
+
+template<size_t N, typename P, bool BASE> uint32_t Allocator<N, P, BASE>::follow(const Chunk* chunk, uint32_t off) noexcept {
+    uint32_t link;
+    std::memcpy(&link, reinterpret_cast<const uint8_t*>(chunk) + off, sizeof(link));
+
+    if constexpr(HARDEN) {
+        link ^= chunk->meta.key ^ (off * 0x9E3779B1u);
+        if(link && (link < Chunk::OFFSET || (link - Chunk::OFFSET) % BLOCK != 0 || (link - Chunk::OFFSET) / BLOCK >= chunk->meta.bump)) {
+            std::abort(); // corrupted, e.g. write after free
+        }
+    }
+    return link;
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::map(Chunk* chunk) noexcept {
+    if constexpr(INTRUSIVE) {
+        if(chunk->meta.flag & Meta::MAPPED) {
+            return; // already
+        }
+
+        census(chunk, chunk->state);
+        chunk->meta.flag |= Meta::MAPPED;
+    }
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::census(const Chunk* chunk, typename Chunk::State& out) noexcept {
+    if constexpr(INTRUSIVE) {
+        out.clear();
+        for(size_t i = 0; i < chunk->meta.bump; ++i) {
+            out.on(i);
+        }
+        for(uint32_t off = chunk->meta.free; off; off = follow(chunk, off)) {
+            out.off((off - Chunk::OFFSET) / BLOCK);
+        }
+    }
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::thread(Chunk* chunk) noexcept {
+    if constexpr(INTRUSIVE) {
+        chunk->meta.free = 0;
+        chunk->meta.bump = 0;
+        if(!(chunk->meta.flag & Meta::MAPPED)) {
+            return; // empty chunk, fresh list
+        }
+
+        // bump: after last live block
+        for(size_t i = (Chunk::COUNT + 63) / 64; i-- > 0;) {
+            const uint64_t bits = chunk->state.word(i);
+            if(bits) {
+                chunk->meta.bump = uint32_t((i << 6) + 63 - size_t(global::bit_clz(bits)));
+                chunk->meta.bump += 1;
+                break;
+            }
+        }
+
+        // link free blocks below bump, lowest first
+        chunk->meta.flag &= ~uint32_t(Meta::MAPPED);
+        for(size_t i = chunk->meta.bump; i-- > 0;) {
+            if(!chunk->state.check(i)) {
+                vacate(chunk, i);
+            }
+        }
+    }
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::remote(Chunk* chunk, void* in) noexcept {
+    if constexpr(!WHOLE) {
+        void* head = chunk->meta.remote.load(std::memory_order_relaxed);
+        do {
+            *static_cast<void**>(in) = head; // link in block
+        } while(!chunk->meta.remote.compare_exchange_weak(head, in, std::memory_order_release, std::memory_order_relaxed));
+    }
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::drain(Chunk* chunk) noexcept {
+    static constexpr size_t MASK = CHUNK - 1;
+
+    size_t cnt  = 0;
+    void*  curr = chunk->meta.remote.exchange(nullptr, std::memory_order_acquire);
+    while(curr) {
+        void* next = *static_cast<void**>(curr);
+        if(chunk->meta.flag & Meta::SAMPLED) {
+            Profiler::forget(curr);
+        }
+        vacate(chunk, ((uintptr_t(curr) - Chunk::OFFSET) & MASK) / BLOCK);
+        --chunk->meta.used;
+        ++counter;
+        ++cnt;
+        curr = next;
+    }
+    refund(cnt);
+    if(chunk->meta.used == 0) {
+        chunk->meta.flag &= ~uint32_t(Meta::SAMPLED); // all forgotten
+        if constexpr(INTRUSIVE) {
+            thread(chunk); // fresh list
+        }
+    }
+    return cnt;
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::collect() noexcept {
+    if constexpr(!WHOLE && REMOTE) {
+        if(current) {
+            drain(current);
+        }
+
+        Stack* list[2] = { &empty, &partial };
+        for(int i = 0; i < 2; ++i) {
+            Chunk* curr = list[i]->head;
+            while(curr) {
+                Chunk* next = curr->meta.next;
+                if(curr->meta.remote.load(std::memory_order_relaxed)) {
+                    list[i]->remove(curr);
+                    drain(curr);
+                    settle(curr);
+                }
+                curr = next;
+            }
+        }
+    }
+}
+
+template<size_t N, typename P, bool BASE> auto Allocator<N, P, BASE>::adopt() noexcept -> Chunk* {
+    if constexpr(!WHOLE && REMOTE) {
+        if(heap) {
+            return nullptr; // heap chunks are not abandoned
+        }
+
+        while(true) {
+            Chunk* chunk;
+            {
+                std::lock_guard<core::Spin> lock(guard);
+                chunk = orphans.pop();
+            }
+            if(!chunk) {
+                return nullptr; // none
+            }
+
+            chunk->meta.outer = this;
+            chunk->meta.home.store(home, std::memory_order_relaxed);
+            own(chunk, this);
+            counter += Chunk::COUNT - chunk->meta.used;
+            if(tag) {
+                tag->debit(chunk->meta.used * BLOCK); // live blocks are refunded by this
+            }
+            drain(chunk);
+
+            if(chunk->meta.used < Chunk::COUNT) {
+                return chunk; // usable
+            }
+            empty.push(chunk); // still full, keep and try next
+        }
+    }
+    return nullptr;
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::settle(Chunk* chunk) noexcept {
+    if(chunk->meta.used == 0) {
+        full.push(chunk);
+    }
+    else if(chunk->meta.used == Chunk::COUNT) {
+        empty.push(chunk);
+    }
+    else partial.push(chunk);
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::own(Chunk* chunk, Allocator* owner) noexcept {
+    for(size_t i = 0; i < CHUNK; i += size_t(1) << Pagemap::SHIFT) {
+        Pagemap::find(reinterpret_cast<uint8_t*>(chunk) + i)->owner = owner;
+    }
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::reserve(size_t cnt) {
+    const size_t have = usable();
+    if(cnt == 0) return 0;    // no reserve
+    if(have >= cnt) return 0; // reserved
+
+    cnt = (cnt - have); // need count
+
+    size_t generated = 0;
+    for(; generated < cnt; generated += Chunk::COUNT) {
+        Chunk* chunk = generate();
+        if(!chunk) {
+            break; // failed
+        }
+        full.push(chunk); // insert
+    }
+    return generated; // create count
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::shrink(size_t limit) {
+    // emptied by release without list update
+    if constexpr(CONCURRENT) {
+        for(Chunk* curr = partial.head; curr;) {
+            Chunk* next = curr->meta.next;
+            if(curr->meta.used == 0) {
+                partial.remove(curr);
+                full.push(curr);
+            }
+            curr = next;
+        }
+    }
+
+    size_t cnt = 0;
+    Chunk* del = cnt < limit ? full.pop() : nullptr; // pop
+
+    while(del != nullptr) {
+        ++cnt;
+        Chunk* temp = cnt < limit ? full.pop() : nullptr; // pop
+        destroy(del);                                     // delete
+        del = temp;                                       // set next
+    }
+
+    // all clear
+    if constexpr(WHOLE) {
+        if(current && cnt < limit) {
+            destroy(current);
+            current = nullptr;
+            ++cnt;
+        }
+    }
+
+    return cnt;
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::scavenge(size_t budget, bool lazy) {
+    if constexpr(WHOLE || N == 0 || CONCURRENT) {
+        return 0; // block is the chunk, or claimed without lock
+    }
+    else {
+        if(heap || mode != Warm::LAZY) {
+            return 0; // file backed, or fault-free requested
+        }
+
+        const size_t unit = grain();
+        const size_t cnt  = CHUNK / unit;
+
+        // byte range of chunk covers free blocks only, header is never free
+        auto vacant = [](const typename Chunk::State& state, size_t lo, size_t hi) -> bool {
+            if(lo < Chunk::OFFSET) {
+                return false;
+            }
+            const size_t first = (lo - Chunk::OFFSET) / BLOCK;
+            if(first >= Chunk::COUNT) {
+                return true; // tail padding
+            }
+            size_t last = (hi - 1 - Chunk::OFFSET) / BLOCK;
+            if(last >= Chunk::COUNT) {
+                last = Chunk::COUNT - 1;
+            }
+            for(size_t i = first; i <= last;) {
+                const size_t   bit  = i & 63;
+                const size_t   len  = 64 - bit < last - i + 1 ? 64 - bit : last - i + 1;
+                const uint64_t mask = (len == 64 ? ~uint64_t(0) : (uint64_t(1) << len) - 1) << bit;
+                if(state.word(i >> 6) & mask) {
+                    return false;
+                }
+                i += len;
+            }
+            return true;
+        };
+
+        size_t out = 0;
+        for(Chunk* curr = partial.head; curr && out < budget; curr = curr->meta.next) {
+            if(curr->meta.flag & Meta::LOCKED) {
+                continue; // pinned by warm
+            }
+
+            // INTRUSIVE: probe a copy, convert only if some grain is free
+            typename Chunk::State        live;
+            const typename Chunk::State* state = &curr->state;
+            if constexpr(INTRUSIVE) {
+                if(!(curr->meta.flag & Meta::MAPPED)) {
+                    census(curr, live);
+                    state = &live;
+                }
+            }
+
+            // coalesce adjacent grains to a call
+            uint8_t* base = reinterpret_cast<uint8_t*>(curr);
+            size_t   run  = 0;
+            for(size_t i = 0; i <= cnt; ++i) {
+                if(i < cnt && !((curr->meta.idle >> i) & 1) && vacant(*state, i * unit, (i + 1) * unit)) {
+                    ++run;
+                    continue;
+                }
+                if(run && out < budget) {
+                    if constexpr(INTRUSIVE) {
+                        map(curr); // free blocks lose links, tracked by bitmap until refaulted
+                    }
+                }
+                if(run && out < budget && global::pal_vreset(base + (i - run) * unit, run * unit, lazy)) {
+                    curr->meta.idle |= ((run == 64 ? ~uint64_t(0) : (uint64_t(1) << run) - 1)) << (i - run);
+                    curr->meta.flag &= ~uint32_t(Meta::WARM);
+                    out += run * unit;
+                }
+                run = 0;
+            }
+        }
+        return out;
+    }
+}
+
+template<size_t N, typename P, bool BASE> Latency& Allocator<N, P, BASE>::latency() noexcept {
+    static thread_local Latency instance;
+    return instance;
+}
+
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::maintain(size_t low, size_t high) {
+    if constexpr(N == 0) return 0;
+
+    size_t cnt = 0;
+
+    // memory pressure: retire all spare chunks
+    if(entry.owner && Registry::pressure() != seen) {
+        seen = Registry::pressure();
+        low  = 0;
+        high = 0;
+        scavenge();
+    }
+
+    // prefault cached chunks generated lazily
+    if constexpr(WHOLE) {
+        if(mode == Warm::LAZY || cold) {
+            while(full.warm < full.top) {
+                Chunk* block = full.vec[full.warm];
+                if(!(mode == Warm::LAZY ? global::pal_vfault(block, BLOCK) : heat(block))) {
+                    break; // failed, retry next call
+                }
+                ++full.warm;
+            }
+            cold = full.warm < full.top;
+        }
+    }
+    else {
+        for(Chunk* curr = full.head; curr; curr = curr->meta.next) {
+            if(!(curr->meta.flag & Meta::WARM) && global::pal_vfault(curr, CHUNK)) {
+                curr->meta.flag |= Meta::WARM;
+                curr->meta.idle  = 0; // refaulted
+            }
+        }
+    }
+
+    // low: generate ahead
+    while(full.size() < low) {
+        Chunk* chunk = generate();
+        if(!chunk) {
+            break; // failed
+        }
+        bool hot = false; // WHOLE: extends warm prefix
+        if(mode == Warm::LAZY) {
+            if constexpr(WHOLE) {
+                hot = global::pal_vfault(chunk, BLOCK) && full.warm == full.top;
+            }
+            else if(global::pal_vfault(chunk, CHUNK)) {
+                chunk->meta.flag |= Meta::WARM;
+            }
+        }
+        if(full.push(chunk) && hot) {
+            if constexpr(WHOLE) {
+                ++full.warm;
+            }
+        }
+        ++cnt;
+    }
+
+    // high: retire surplus
+    while(full.size() > high) {
+        destroy(full.pop());
+        ++cnt;
+    }
+    return cnt;
+}
+
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::reset() {
+    if constexpr(WHOLE) {
+        while(Chunk* chunk = empty.pop()) {
+            if(STATS && Profiler::live()) {
+                Profiler::forget(chunk);
+            }
+            Pagemap::find(chunk)->slot = 0;
+            full.push(chunk);
+            ++counter;
+            refund();
+        }
+    }
+    else {
+        if(current) {
+            full.push(current);
+            current = nullptr;
+        }
+
+        Stack* list[2] = { &empty, &partial };
+        for(int i = 0; i < 2; ++i) {
+            while(Chunk* chunk = list[i]->pop()) {
+                full.push(chunk);
+            }
+        }
+
+        for(Chunk* curr = full.head; curr; curr = curr->meta.next) {
+            // forget sampled live blocks
+            if(curr->meta.flag & Meta::SAMPLED) {
+                if constexpr(INTRUSIVE) {
+                    map(curr);
+                }
+                uint8_t* data = reinterpret_cast<uint8_t*>(curr) + Chunk::OFFSET;
+                for(size_t i = 0; i < (Chunk::COUNT + 63) / 64; ++i) {
+                    for(uint64_t bits = curr->state.word(i); bits; bits &= bits - 1) {
+                        Profiler::forget(data + ((i << 6) + size_t(global::bit_ctz(bits))) * BLOCK);
+                    }
+                }
+                curr->meta.flag &= ~uint32_t(Meta::SAMPLED);
+            }
+            curr->meta.remote.store(nullptr, std::memory_order_relaxed);
+            curr->state.clear();
+            if constexpr(INTRUSIVE) {
+                curr->meta.free  = 0;
+                curr->meta.bump  = 0;
+                curr->meta.flag &= ~uint32_t(Meta::MAPPED);
+            }
+            counter        += curr->meta.used;
+            refund(curr->meta.used);
+            curr->meta.used = 0;
+            curr->meta.flag &= ~uint32_t(Meta::PARKED);
+        }
+    }
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U, typename Fn> void Allocator<N, P, BASE>::for_each_live(Fn&& fn) {
+    if constexpr(N == 0) return;
+
+    if constexpr(WHOLE) {
+        sweep([&fn](Chunk* chunk) { fn(reinterpret_cast<U*>(chunk)); });
+    }
+    else {
+        collect(); // drop remote frees
+
+        const size_t line = global::pal_cacheline();
+        const size_t span = BLOCK < line * 4 ? BLOCK : line * 4; // head of next block, up to 4 lines
+
+        sweep([&fn, line, span](Chunk* chunk) {
+            if constexpr(INTRUSIVE) {
+                map(chunk); // lazy conversion
+            }
+            uint8_t* data = reinterpret_cast<uint8_t*>(chunk) + Chunk::OFFSET;
+
+            for(size_t i = 0; i < (Chunk::COUNT + 63) / 64; ++i) {
+                uint64_t bits = chunk->state.word(i);
+                while(bits) {
+                    const size_t index = (i << 6) + size_t(global::bit_ctz(bits));
+                    bits &= bits - 1; // next set bit
+                    if(bits) {
+                        const uint8_t* next = data + ((i << 6) + size_t(global::bit_ctz(bits))) * BLOCK;
+                        for(size_t off = 0; off < span; off += line) {
+                            global::pal_prefetch(next + off);
+                        }
+                    }
+                    fn(reinterpret_cast<U*>(data + index * BLOCK));
+                }
+            }
+        });
+    }
+}
+
+template<size_t N, typename P, bool BASE>
+template<typename U> void Allocator<N, P, BASE>::destroy_all() {
+    if constexpr(std::is_same_v<U, void> == false) {
+        for_each_live<U>([](U* ptr) { ptr->~U(); });
+    }
+    reset();
+}
 
-    //! @brief object count to byte, divied to sizeof(uint_64), and round up
-    using State = core::Mask<(COUNT + 63) / 64>;
+template<size_t N, typename P, bool BASE>
+template<typename U, typename Fn> size_t Allocator<N, P, BASE>::compact(size_t budget, Fn&& fn) {
+    if constexpr(WHOLE || N == 0) {
+        return 0; // 1 block per chunk
+    }
+    else {
+        collect(); // exact usage
 
-    //! @brief [ meta | state | PADDING | data ]
-    static constexpr size_t OFFSET  = ((sizeof(Meta) + sizeof(State)) / BLOCK) * BLOCK; // align
-    static constexpr size_t PADDING = OFFSET - (sizeof(Meta) + sizeof(State));
+        size_t moved = 0;
+        while(moved < budget) {
+            // source: sparsest, destination: densest
+            Chunk* from = nullptr;
+            Chunk* to   = nullptr;
+            for(Chunk* curr = partial.head; curr; curr = curr->meta.next) {
+                if(!from || curr->meta.used < from->meta.used) from = curr;
+            }
+            for(Chunk* curr = partial.head; curr; curr = curr->meta.next) {
+                if(curr != from && (!to || curr->meta.used > to->meta.used)) to = curr;
+            }
+            if(!to && current && current->meta.used < Chunk::COUNT) {
+                to = current; // last: current
+            }
+            if(!from || !to || from->meta.used > to->meta.used) {
+                break; // dense enough
+            }
 
-    //! @brief size check
-    static_assert((sizeof(Meta) + sizeof(State) + PADDING + BLOCK * COUNT) <= CHUNK);
+            if constexpr(INTRUSIVE) {
+                map(from);
+                map(to);
+            }
 
-    Meta    meta;
-    State   state;
-    uint8_t data[CHUNK - sizeof(meta) - sizeof(state)];
-};
+            // evacuate
+            uint8_t* src = reinterpret_cast<uint8_t*>(from) + Chunk::OFFSET;
+            uint8_t* dst = reinterpret_cast<uint8_t*>(to) + Chunk::OFFSET;
+            for(size_t i = 0; i < (Chunk::COUNT + 63) / 64 && moved < budget && to->meta.used < Chunk::COUNT; ++i) {
+                uint64_t bits = from->state.word(i);
+                while(bits && moved < budget && to->meta.used < Chunk::COUNT) {
+                    const size_t index = (i << 6) + size_t(global::bit_ctz(bits));
+                    bits &= bits - 1;
 
-template<size_t N, bool BASE>::Allocator<N, BASE>::~Allocator() {
-    Stack* list[3] = { &empty, &full, &partial };
-    for(int i = 0; i < 3; ++i) {
-        Stack* stack = list[i];
+                    const size_t slot = to->state.next();
+                    to->state.on(slot);
+                    ++to->meta.used;
+                    if(to->meta.idle) {
+                        touch(to, slot);
+                    }
 
-        Chunk* curr = stack->pop(); // pop curr
-        while(curr != nullptr) {
-            Chunk* next = stack->pop(); // pop next
-            destroy(curr);              // delete curr
-            curr = next;                // curr to next
+                    fn(reinterpret_cast<U*>(src + index * BLOCK), reinterpret_cast<U*>(dst + slot * BLOCK));
+                    if(from->meta.flag & Meta::SAMPLED) {
+                        Profiler::move(src + index * BLOCK, dst + slot * BLOCK); // still live, at new address
+                        to->meta.flag |= Meta::SAMPLED;
+                    }
+
+                    if(from->meta.id) {
+                        uint8_t* gen = generation(uint32_t((from->meta.id << SLOT) | index));
+                        if(gen) {
+                            ++*gen; // handles of source are stale
+                        }
+                    }
+
+                    from->state.off(index);
+                    --from->meta.used;
+                    ++moved;
+                }
+            }
+
+            // destination filled: partial -> empty
+            if(to->meta.used == Chunk::COUNT) {
+                if constexpr(CONCURRENT) {
+                    to->meta.flag |= Meta::PARKED;
+                }
+                if(to == current) {
+                    empty.push(current);
+                    current = nullptr;
+                }
+                else {
+                    partial.remove(to);
+                    empty.push(to);
+                }
+            }
+
+            // source emptied: release
+            if(from->meta.used == 0) {
+                partial.remove(from);
+                destroy(from);
+            }
         }
-    }
-    if(current) {
-        destroy(current);
+        return moved;
     }
 }
 
-template<size_t N, bool BASE>
-template<typename U, typename... Args> U* Allocator<N, BASE>::acquire(Args&&... in) noexcept {
-    if constexpr(N == 0) {
-        return nullptr;
+template<size_t N, typename P, bool BASE>
+template<typename Fn> void Allocator<N, P, BASE>::sweep(Fn&& fn) {
+    // gather
+    size_t cnt = empty.size();
+    if constexpr(!WHOLE) {
+        cnt += partial.size() + (current ? 1 : 0);
+    }
+    if(cnt == 0) {
+        return;
     }
 
-    // huge pages
-    if constexpr (WHOLE) {
-        Chunk* temp = full.pop(); // pop
-        if (!temp) {
-            temp = generate(); // alloc
+    const size_t byte = cnt * sizeof(Chunk*);
+    Chunk**      vec  = global::pal_valloc<Chunk*>(byte);
+    size_t       top  = 0;
+
+    // vec is nullptr if failed: list order
+    auto each = [&](Chunk* chunk) {
+        if(vec) {
+            vec[top++] = chunk;
         }
-        empty.push(temp); // push
-        if constexpr(std::is_same_v<U, void>) {
-            return temp; // return
+        else fn(chunk);
+    };
+
+    if constexpr(WHOLE) {
+        for(size_t i = 0; i < empty.top; ++i) {
+            each(empty.vec[i]);
         }
-        else return CXX_LAUNDER(reinterpret_cast<U*>(temp)); // return with launder
     }
-
-    // check block
-    if(!current) {
-        current = full.pop(); // first: recycle
-        if(!current) {
-            current = partial.pop(); // second: recycle
-            if(!current) {
-                current = generate(); // last: alloc
-                if(!current) {
-                    return nullptr; // failed
-                }
+    else {
+        if(current) {
+            each(current);
+        }
+        Stack* list[2] = { &empty, &partial };
+        for(int i = 0; i < 2; ++i) {
+            for(Chunk* curr = list[i]->head; curr; curr = curr->meta.next) {
+                each(curr);
             }
         }
     }
 
-    // check state
-    size_t index = current->state.next();
-    current->state.on(index);
-
-    // return
-    void* out = reinterpret_cast<uint8_t*>(current) + Chunk::OFFSET + index * BLOCK;
-
-    // get meta, and MAX to index
-    // usage partial -> empty
-    if(++current->meta.used > Chunk::COUNT - 1) {
-        empty.push(current);
-        current = nullptr; // prepare next chunk
-    }
-    --counter; // count
-
-    // call constructor
-    if constexpr(std::is_same_v<U, void> == false) {
-        if constexpr(sizeof...(Args) != 0) {
-            return new(out) U(std::forward<Args>(in)...);
+    // address order
+    if(vec) {
+        std::sort(vec, vec + top);
+        for(size_t i = 0; i < top; ++i) {
+            fn(vec[i]);
         }
-        else return new(out) U();
-        return CXX_LAUNDER(static_cast<U*>(out));
+        global::pal_vfree(vec, byte);
     }
-    else return out;
 }
 
-template<size_t N, bool BASE>
-template<typename U> void Allocator<N, BASE>::release(U* in) {
-    // call destrcutor
-    if constexpr(std::is_same_v<U, void> == false) {
-        in->~U();
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::enroll() noexcept {
+    if constexpr(CONCURRENT) {
+        return; // shrink by pressure runs on one thread, others may be in the chunk
     }
+    entry.owner  = this;
+    entry.chunk  = CHUNK;
+    entry.idle   = [](const void* owner) { return static_cast<const Allocator*>(owner)->full.size() * CHUNK; };
+    entry.shrink = [](void* owner, size_t cnt) { return static_cast<Allocator*>(owner)->shrink(cnt); };
+    if constexpr(!WHOLE && REMOTE) {
+        entry.take = [](void* owner) { return static_cast<Allocator*>(owner)->deferred.exchange(nullptr, std::memory_order_acquire); };
+    }
+    seen         = Registry::pressure();
+    Registry::insert(&entry);
+}
 
-    if constexpr(N == 0) return;
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::relieve() noexcept {
+    const uint32_t now = Registry::pressure();
+    if(now != seen && entry.owner) {
+        seen = now;
+        Registry::reclaim(); // every allocator of this thread, biggest idle footprint first
+        scavenge();
+    }
+}
 
-    // huge pages
-    if constexpr (WHOLE) {
-        Chunk* chunk = reinterpret_cast<Chunk*>(in);
-        // check
-        if(empty.remove(chunk) == false) {
-            std::abort(); // not found
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::usable() {
+    if constexpr(CONCURRENT) {
+        size_t cnt = current ? Chunk::COUNT - current->meta.used : 0;
+        Stack* list[3] = { &full, &partial, &empty };
+        for(int i = 0; i < 3; ++i) {
+            for(Chunk* curr = list[i]->head; curr; curr = curr->meta.next) {
+                cnt += Chunk::COUNT - curr->meta.used;
+            }
         }
-        full.push(chunk); // OK
-        return;
+        return cnt;
     }
+    return counter;
+}
 
-    // get chunk info
-    Chunk*    chunk;
-    ptrdiff_t index;
+template<size_t N, typename P, bool BASE> void* Allocator<N, P, BASE>::grab() noexcept {
+    if constexpr(CONCURRENT) {
+        Chunk* chunk = current;
+        while(true) {
+            // reserve by usage first, then a free bit exists until claimed
+            if(chunk) {
+                uint32_t used = chunk->meta.used.load(std::memory_order_relaxed);
+                while(used < Chunk::COUNT) {
+                    if(chunk->meta.used.compare_exchange_weak(used, used + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                        size_t index;
+                        while((index = chunk->state.claim()) == size_t(-1)) {
+                            global::pal_pause(); // bit of reserved block is moved by other threads
+                        }
+                        return reinterpret_cast<uint8_t*>(chunk) + Chunk::OFFSET + index * BLOCK;
+                    }
+                }
+            }
 
-    static constexpr size_t MASK = CHUNK - 1; // e.g. if CHUNK 65536 then operate by 0xFFFF
+            // full: switch current
+            std::lock_guard<core::Spin> lock(latch);
+            if(current != chunk) {
+                chunk = current; // switched by other thread
+                continue;
+            }
+            if(chunk) {
+                park(chunk);
+            }
 
-    // find chunk begin address
-    chunk = reinterpret_cast<Chunk*>(uintptr_t(in) & ~MASK); // known UB but safe in practice
+            // recycle, or alloc
+            chunk = full.pop();
+            while(!chunk) {
+                chunk = partial.pop();
+                if(!chunk) {
+                    chunk = generate();
+                    break;
+                }
+                if(chunk->meta.used.load(std::memory_order_acquire) < Chunk::COUNT) {
+                    break;
+                }
+                park(chunk); // filled by acquire that read old current
+                chunk = nullptr;
+            }
+            current = chunk;
+            if(!chunk) {
+                return nullptr; // failed
+            }
+        }
+    }
+    return nullptr;
+}
 
-    // calculate index of the block within the chunk
-    index = ((uintptr_t(in) - Chunk::OFFSET) & MASK) / BLOCK; // optimize by compiler
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::drop(Chunk* chunk, size_t index) noexcept {
+    if constexpr(CONCURRENT) {
+        if(!chunk->state.vacate(index)) {
+            std::abort(); // double free
+        }
 
-    // check pool
-    if(chunk->meta.outer != this) std::abort();
+        // usage empty -> partial, parked by grab
+        if(chunk->meta.used.fetch_sub(1, std::memory_order_release) == Chunk::COUNT) {
+            std::lock_guard<core::Spin> lock(latch);
+            if(chunk->meta.flag & Meta::PARKED) {
+                chunk->meta.flag &= ~uint32_t(Meta::PARKED);
+                empty.remove(chunk);
+                partial.push(chunk);
+            }
+        }
+    }
+}
 
-    // set state and check
-    chunk->state.off(index);
-    if(chunk != current) {
-        // usage empty -> partial
-        if(chunk->meta.used == Chunk::COUNT) {
-            empty.remove(chunk);
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::park(Chunk* chunk) noexcept {
+    if constexpr(CONCURRENT) {
+        // release from full reads PARKED after this under latch
+        if(chunk->meta.used.load(std::memory_order_acquire) < Chunk::COUNT) {
             partial.push(chunk);
         }
-        // usage partial -> full
-        if(chunk->meta.used == 1) {
-            partial.remove(chunk);
-            full.push(chunk);
+        else {
+            chunk->meta.flag |= Meta::PARKED;
+            empty.push(chunk);
         }
     }
-    --chunk->meta.used; // decount
-    ++counter;
 }
 
-template<size_t N, bool BASE> size_t Allocator<N, BASE>::reserve(size_t cnt) {
-    if(cnt == 0) return 0;       // no reserve
-    if(counter >= cnt) return 0; // reserved
+template<size_t N, typename P, bool BASE> void* Allocator<N, P, BASE>::seek(size_t align) noexcept {
+    if constexpr(WHOLE || N == 0 || CONCURRENT) {
+        return nullptr; // always naturally aligned, or shared chunk
+    }
+    else {
+        // block addresses repeat alignment residue every (align / ALIGN) blocks
+        const size_t STEP  = align / ALIGN;
+        size_t       first = 0;
+        while(first < STEP && ((Chunk::OFFSET + first * BLOCK) & (align - 1)) != 0) {
+            ++first;
+        }
+        if(first >= STEP || first >= Chunk::COUNT) {
+            return nullptr; // no aligned block in chunk
+        }
+
+        // find aligned free block in chunk
+        auto find = [first, STEP](Chunk* chunk) -> size_t {
+            if constexpr(INTRUSIVE) {
+                map(chunk); // threaded again when used as current
+            }
+            for(size_t i = first; i < Chunk::COUNT; i += STEP) {
+                if(!chunk->state.check(i)) return i;
+            }
+            return size_t(-1);
+        };
+
+        Chunk* chunk = nullptr;
+        Stack* from  = nullptr; // source list, nullptr is current or generated
+        size_t index = size_t(-1);
 
-    cnt = (cnt - counter); // need count
+        // first: current
+        if(current) {
+            index = find(current);
+            if(index != size_t(-1)) chunk = current;
+        }
 
-    size_t generated = 0;
-    for(; generated < cnt; generated += Chunk::COUNT) {
-        Chunk* chunk = generate();
+        // second: partial, third: full
+        Stack* list[2] = { &partial, &full };
+        for(int i = 0; i < 2 && !chunk; ++i) {
+            for(Chunk* curr = list[i]->head; curr; curr = curr->meta.next) {
+                index = find(curr);
+                if(index != size_t(-1)) {
+                    chunk = curr;
+                    from  = list[i];
+                    break;
+                }
+            }
+        }
+
+        // last: alloc
         if(!chunk) {
-            break; // failed
+            chunk = generate();
+            if(!chunk) {
+                return nullptr; // failed
+            }
+            index = first;
+            if(current) {
+                full.push(chunk); // as recycled chunk
+                from = &full;
+            }
+            else current = chunk; // use as current
         }
-        full.push(chunk); // insert
-    }
-    return generated; // create count
-}
 
-template<size_t N, bool BASE> size_t Allocator<N, BASE>::shrink() {
-    size_t cnt = 0;
-    Chunk* del = full.pop(); // pop
+        if constexpr(INTRUSIVE) {
+            map(chunk); // generated
+        }
+        chunk->state.on(index);
+        if(chunk->meta.idle) {
+            touch(chunk, index);
+        }
+        ++chunk->meta.used;
+        --counter;
 
-    while(del != nullptr) {
-        Chunk* temp = full.pop(); // pop
-        destroy(del);             // delete
-        del = temp;               // set next
-        ++cnt;
+        void* out = reinterpret_cast<uint8_t*>(chunk) + Chunk::OFFSET + index * BLOCK;
+        if constexpr(STATS) {
+            if(Profiler::tick(BLOCK) && Profiler::sample(out, BLOCK)) {
+                chunk->meta.flag |= Meta::SAMPLED;
+            }
+        }
+
+        // update chunk state
+        if(chunk == current) {
+            // usage partial -> empty
+            if(chunk->meta.used > Chunk::COUNT - 1) {
+                empty.push(current);
+                current = nullptr;
+            }
+        }
+        else {
+            from->remove(chunk);
+            // usage full -> partial or empty
+            if(chunk->meta.used == Chunk::COUNT) {
+                empty.push(chunk);
+            }
+            else partial.push(chunk);
+        }
+
+        return reinterpret_cast<uint8_t*>(chunk) + Chunk::OFFSET + index * BLOCK;
     }
+}
 
-    // all clear
+template<size_t N, typename P, bool BASE> bool Allocator<N, P, BASE>::warm(Warm in) {
+    const Warm old = mode;
+    mode           = in;
+
+    bool result = true;
     if constexpr(WHOLE) {
+        Stack* list[2] = { &full, &empty };
+        for(int i = 0; i < 2; ++i) {
+            for(size_t j = 0; j < list[i]->top; ++j) {
+                if(old == Warm::LOCK && mode != Warm::LOCK) {
+                    global::pal_vunlock(list[i]->vec[j], BLOCK); // no chunk flag, every chunk was locked by old mode
+                }
+                result &= heat(list[i]->vec[j]);
+            }
+        }
+        cold = !result;
+        if(mode != Warm::LAZY && result) {
+            full.warm = full.top; // all heated
+        }
+    }
+    else {
         if(current) {
-            destroy(current);
-            current = nullptr;
-            ++cnt;
+            result &= heat(current);
+        }
+        Stack* list[3] = { &full, &partial, &empty };
+        for(int i = 0; i < 3; ++i) {
+            for(Chunk* curr = list[i]->head; curr; curr = curr->meta.next) {
+                result &= heat(curr);
+            }
         }
     }
+    return result;
+}
 
-    return cnt;
+template<size_t N, typename P, bool BASE> size_t Allocator<N, P, BASE>::ready() const {
+    if constexpr(WHOLE) {
+        if(mode == Warm::LAZY) {
+            return full.warm; // prefaulted by maintain
+        }
+        return cold ? 0 : full.top; // cached blocks
+    }
+    else {
+        size_t cnt = 0;
+        if(current && (current->meta.flag & Meta::WARM)) {
+            cnt += Chunk::COUNT - current->meta.used;
+        }
+        const Stack* list[2] = { &full, &partial };
+        for(int i = 0; i < 2; ++i) {
+            for(const Chunk* curr = list[i]->head; curr; curr = curr->meta.next) {
+                if(curr->meta.flag & Meta::WARM) {
+                    cnt += Chunk::COUNT - curr->meta.used;
+                }
+            }
+        }
+        return cnt;
+    }
 }
 
-template<size_t N, bool BASE> size_t Allocator<N, BASE>::usable() {
-    return counter;
+template<size_t N, typename P, bool BASE> bool Allocator<N, P, BASE>::heat(Chunk* in) noexcept {
+    bool result = true;
+
+    if constexpr(WHOLE) {
+        if(mode == Warm::LOCK) {
+            result = global::pal_vlock(in, BLOCK);
+        }
+        else if(mode == Warm::PREFAULT) {
+            result = global::pal_vfault(in, BLOCK);
+        }
+        // LAZY: nothing to populate, locked chunks are unlocked by warm
+    }
+    else {
+        uint32_t& flag = in->meta.flag;
+
+        // unlock
+        if(mode != Warm::LOCK && (flag & Meta::LOCKED)) {
+            global::pal_vunlock(in, CHUNK);
+            flag &= ~uint32_t(Meta::LOCKED);
+        }
+
+        // populate
+        if(mode == Warm::LOCK && !(flag & Meta::LOCKED)) {
+            result = global::pal_vlock(in, CHUNK);
+            flag |= result ? uint32_t(Meta::LOCKED | Meta::WARM) : 0;
+        }
+        else if(mode == Warm::PREFAULT && !(flag & Meta::WARM)) {
+            result = global::pal_vfault(in, CHUNK);
+            flag |= result ? uint32_t(Meta::WARM) : 0;
+        }
+        if(flag & Meta::WARM) {
+            in->meta.idle = 0; // refaulted
+        }
+        else if(mode == Warm::LAZY) {
+            flag &= ~uint32_t(Meta::WARM); // not guaranteed anymore
+        }
+    }
+    return result;
 }
 
-template<size_t N, bool BASE> auto Allocator<N, BASE>::generate() noexcept -> Chunk* {
+template<size_t N, typename P, bool BASE> auto Allocator<N, P, BASE>::generate() noexcept -> Chunk* {
     Chunk* ptr;
 
     // WHOLE CHUNK does not require align
     if constexpr(WHOLE) {
-        ptr = global::pal_valloc<Chunk>(BLOCK); // 1 chunk == 1 block
+        if(backend) {
+            ptr = static_cast<Chunk*>(backend->generate(backend, BLOCK, ALIGN));
+        }
+        else ptr = global::pal_valloc<Chunk>(BLOCK); // 1 chunk == 1 block
+
+        if(P::BACKING == Backing::HUGE && !backend) {
+            global::pal_vhuge(ptr, BLOCK); // hint
+        }
     }
     
     else {
-        ptr = global::pal_valloc<Chunk>(CHUNK, CHUNK); // other: aligned to CHUNK
+        if(heap) {
+            ptr = static_cast<Chunk*>(heap->map(CHUNK, CHUNK)); // carve from heap
+        }
+        else if(backend) {
+            ptr = static_cast<Chunk*>(backend->generate(backend, CHUNK, CHUNK)); // user supplied
+        }
+        else {
+            ptr = P::BACKING != Backing::DIRECT ? static_cast<Chunk*>(Cache::take(CHUNK)) : nullptr; // emptied by any size class
+            if(!ptr) {
+                ptr = global::pal_valloc<Chunk>(CHUNK, CHUNK); // other: aligned to CHUNK
+            }
+            if(P::BACKING == Backing::HUGE && ptr) {
+                global::pal_vhuge(ptr, CHUNK); // hint, cached chunk may come from other backing
+            }
+        }
+
         if(ptr) {
             new(ptr) Chunk;         // init for life cycle
+            ptr->state.clear();     // may be recycled memory
             ptr->meta.outer = this; // set outer
+            ptr->meta.home.store(home, std::memory_order_relaxed);
+            if constexpr(HARDEN) {
+                ptr->meta.key = uint32_t(((global::pal_tick() ^ uintptr_t(ptr)) * 0x9E3779B97F4A7C15ull) >> 32);
+            }
+            if(!heap) {
+                std::lock_guard<core::Spin> lock(guard);
+                ptr->meta.id = table.insert(ptr); // 0 if full
+            }
+        }
+    }
+
+    // register for lookup by address
+    if(ptr && !heap && !Pagemap::insert(ptr, CHUNK, this, &CLASS)) {
+        if constexpr(!WHOLE) {
+            if(ptr->meta.id) {
+                std::lock_guard<core::Spin> lock(guard);
+                table.erase(ptr->meta.id);
+            }
+            ptr->~Chunk();
+        }
+        if(backend) {
+            backend->destroy(backend, ptr, CHUNK);
         }
+        else global::pal_vfree(ptr, CHUNK);
+        return nullptr; // address out of range
     }
 
     if(ptr) {
         counter += Chunk::COUNT; // add
+
+        // warm-start
+        if(mode != Warm::LAZY && !heat(ptr) && WHOLE) {
+            cold = true;
+        }
     }
     return ptr;
 }
 
-template<size_t N, bool BASE> void Allocator<N, BASE>::destroy(Chunk* in) noexcept {
+template<size_t N, typename P, bool BASE> void Allocator<N, P, BASE>::destroy(Chunk* in) noexcept {
+    if(!heap) {
+        Pagemap::erase(in, CHUNK); // unregister
+    }
+
     // matches the parameter when pal_valloc is called
     if constexpr(WHOLE) {
-        global::pal_vfree(in, BLOCK); // 1 chunk == 1 block
+        if(backend) {
+            backend->destroy(backend, in, BLOCK);
+        }
+        else global::pal_vfree(in, BLOCK); // 1 chunk == 1 block
     }
     else {
+        if(in->meta.flag & Meta::LOCKED) {
+            global::pal_vunlock(in, CHUNK); // heap is not unmapped
+        }
+        if(in->meta.id) {
+            std::lock_guard<core::Spin> lock(guard);
+            table.erase(in->meta.id);
+        }
         in->~Chunk();
-        global::pal_vfree(in, CHUNK); // other: aligned to CHUNK
+        if(heap) {
+            heap->unmap(in, CHUNK); // return to heap
+        }
+        else if(backend) {
+            backend->destroy(backend, in, CHUNK); // return to backend
+        }
+        else if(P::BACKING == Backing::DIRECT || !Cache::give(in, CHUNK)) {
+            global::pal_vfree(in, CHUNK); // other: aligned to CHUNK
+        }
     }
     counter -= Chunk::COUNT;
 }
 
-template<size_t N, bool BASE> struct Allocator<N, BASE>::List {
+template<size_t N, typename P, bool BASE> struct Allocator<N, P, BASE>::Hot {
+    Hot& operator=(Chunk* in) noexcept {
+        ptr.store(in, std::memory_order_release);
+        return *this;
+    }
+
+    Chunk* get() const noexcept {
+        return ptr.load(std::memory_order_acquire);
+    }
+
+    Chunk* operator->() const noexcept { return get(); }
+    operator Chunk*() const noexcept { return get(); }
+
+    std::atomic<Chunk*> ptr{ nullptr };
+};
+
+template<size_t N, typename P, bool BASE> struct Allocator<N, P, BASE>::List {
     bool remove(Chunk* in) {
         Chunk* prev = in->meta.prev;
         Chunk* next = in->meta.next;
         if (prev) prev->meta.next = next;
         if (next) next->meta.prev = prev;
         if (in == head) head = next;
+        --count;
 
         return true;
     }
@@ -253,6 +1932,7 @@ template<size_t N, bool BASE> struct Allocator<N, BASE>::List {
             head->meta.prev = in; // link
         }
         head = in; // new head
+        ++count;
 
         return true;
     }
@@ -261,25 +1941,31 @@ template<size_t N, bool BASE> struct Allocator<N, BASE>::List {
         Chunk* out = head;
         if (out) {
             head = out->meta.next;
+            if (head) {
+                head->meta.prev = nullptr; // unlink
+            }
             out->meta.next = nullptr;
             out->meta.prev = nullptr;
+            --count;
         }
         return out;
     }
 
-    Chunk* head = nullptr;
+    size_t size() const {
+        return count;
+    }
+
+    core::Offset<Chunk> head;
+    size_t              count = 0;
 };
 
-template<size_t N, bool BASE> struct Allocator<N, BASE>::Array {
-    bool remove(Chunk* in) {
-        for (int i = 0; i < top; ++i) {
-            if (vec[i] == in) {
-                --top;             // reduce
-                vec[i] = vec[top]; // swap and delete
-                return true;
-            }
-        }
-        return false;
+template<size_t N, typename P, bool BASE> struct Allocator<N, P, BASE>::Array {
+    //! @return chunk moved to index, nullptr if index was last
+    Chunk* remove(size_t index) {
+        --top;                  // reduce
+        vec[index] = vec[top];  // swap and delete
+        warm = index < warm ? index : warm;
+        return index < top ? vec[index] : nullptr;
     }
 
     bool push(Chunk* in) {
@@ -310,10 +1996,56 @@ template<size_t N, bool BASE> struct Allocator<N, BASE>::Array {
         if (top == 0) {
             return nullptr;
         }
-        return vec[--top];
+        warm = --top < warm ? top : warm;
+        return vec[top];
+    }
+
+    size_t size() const {
+        return top;
+    }
+
+    Chunk** vec  = nullptr;
+    size_t  top  = 0;
+    size_t  cap  = 0;
+    size_t  warm = 0; //!< vec[0, warm) is faulted, WHOLE full only
+};
+
+template<size_t N, typename P, bool BASE> struct Allocator<N, P, BASE>::Table {
+    //! @return id, 0 if full or failed, call with guard
+    uint32_t insert(Chunk* in) {
+        if(!chunk) {
+            // [ chunk | gen | free ids ], reserved once, pages are committed on touch
+            void* mem = global::pal_valloc(IDS * (sizeof(*chunk) + sizeof(*gen) + sizeof(*free)));
+            if(!mem) {
+                return 0; // failed
+            }
+            chunk = static_cast<std::atomic<Chunk*>*>(mem);
+            gen   = reinterpret_cast<std::atomic<uint8_t*>*>(chunk + IDS);
+            free  = reinterpret_cast<uint32_t*>(gen + IDS);
+        }
+
+        uint32_t id;
+        if(count) {
+            id = free[--count]; // recycle, generation is kept
+        }
+        else if(next < IDS) {
+            id = next++;
+        }
+        else return 0; // full
+
+        chunk[id].store(in, std::memory_order_release);
+        return id;
+    }
+
+    //! @brief call with guard
+    void erase(uint32_t id) {
+        chunk[id].store(nullptr, std::memory_order_release);
+        free[count++] = id;
     }
 
-    Chunk** vec = nullptr;
-    size_t  top = 0;
-    size_t  cap = 0;
+    std::atomic<Chunk*>*   chunk = nullptr; //!< id to chunk
+    std::atomic<uint8_t*>* gen   = nullptr; //!< id to block counters
+    uint32_t*              free  = nullptr; //!< erased ids
+    uint32_t               next  = 1;       //!< 0 is reserved as null
+    uint32_t               count = 0;       //!< erased id count
 };
@@ -0,0 +1,21 @@
+#ifndef MEM_BACKEND_HPP
+#define MEM_BACKEND_HPP
+
+#include "../global/pal.hpp"
+
+/**
+ * @brief chunk memory source of Allocator, replaces pal_valloc and pal_vfree of generate and destroy
+ * @note  fill the function pointers or derive like Region, must outlive allocators using it,
+ *        chunks are registered to Pagemap, so memory must be in the Pagemap address range
+ *
+ * [usage]
+ * static uint8_t mem[64 << 20];
+ * Region         region(mem, sizeof(mem));
+ * Allocator<64>  alloc(&region); // no syscall, nullptr when region is exhausted
+ */
+struct Backend {
+    void* (*generate)(Backend* self, size_t byte, size_t align) noexcept; //!< nullptr if out of memory
+    void  (*destroy)(Backend* self, void* ptr, size_t byte) noexcept;    //!< same size used when calling generate
+};
+
+#endif
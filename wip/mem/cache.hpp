@@ -0,0 +1,82 @@
+#ifndef MEM_CACHE_HPP
+#define MEM_CACHE_HPP
+
+#include "../core/spin.hpp"
+#include "../global/bit.hpp"
+#include "../global/pal.hpp"
+#include <atomic>
+#include <mutex>
+
+/**
+ * @brief process wide cache of empty chunks shared by size classes, bins by chunk size from 64KiB
+ * @note  allocators give chunks in destroy and take in generate, then re-initialize the chunk for its class,
+ *        up to MEM_CACHE bytes are kept, the rest and trimmed chunks are returned by syscall,
+ *        heap, backend and WHOLE chunks are not cached
+ */
+class Cache {
+public:
+    static constexpr size_t BASE = global::PAL_BOUNDARY; //!< smallest chunk size
+    static constexpr size_t BINS =
+        size_t(global::bit_log2(global::PAL_HUGEPAGE) - global::bit_log2(global::PAL_BOUNDARY)); //!< power of 2 sizes below PAL_HUGEPAGE
+
+public:
+    /**
+     * @brief take a cached chunk
+     *
+     * @param [in] byte chunk size, aligned to byte
+     * @return nullptr if none or not cacheable size, contents are not cleared
+     */
+    static void* take(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief keep a chunk, caller must unregister it before
+     *
+     * @param [in] ptr  chunk from pal_valloc(byte, byte)
+     * @param [in] byte chunk size
+     * @return false if not kept: full or not cacheable size, caller frees it
+     */
+    static bool give(void* ptr, size_t byte) noexcept;
+
+public:
+    /**
+     * @brief syscall: free cached chunks, larger first
+     *
+     * @param [in] byte OPTIONAL: bytes to free at least, 0 is all
+     * @return freed bytes
+     */
+    static size_t trim(size_t byte = 0) noexcept;
+
+public:
+    /**
+     * @brief change max cached bytes, surplus is trimmed
+     *
+     * @param [in] byte 0 disables
+     */
+    static void limit(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief cached bytes
+     */
+    static size_t size() noexcept;
+
+private:
+    //! @brief bin of power of 2 size, BINS if not cacheable
+    static size_t bin(size_t byte) noexcept;
+
+private:
+    //! @brief cached chunk, linked in its first bytes
+    struct Node {
+        Node* next;
+    };
+
+private:
+    static inline core::Spin          lock;                 //!< bins lock
+    static inline Node*               bins[BINS] = {};      //!< cached chunks by size
+    static inline std::atomic<size_t> bytes{ 0 };           //!< cached bytes
+    static inline std::atomic<size_t> max{ size_t(MEM_CACHE) }; //!< limit
+};
+
+#include "cache.ipp"
+#endif
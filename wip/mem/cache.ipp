@@ -0,0 +1,80 @@
+#ifndef MEM_CACHE_HPP
+#    include "cache.hpp"
+#endif
+
+inline void* Cache::take(size_t byte) noexcept {
+    const size_t index = bin(byte);
+    if(index >= BINS || bytes.load(std::memory_order_relaxed) == 0) {
+        return nullptr; // not cacheable, or empty
+    }
+
+    std::lock_guard<core::Spin> guard(lock);
+
+    Node* node = bins[index];
+    if(!node) {
+        return nullptr;
+    }
+    bins[index] = node->next;
+    bytes.fetch_sub(byte, std::memory_order_relaxed);
+    return node;
+}
+
+inline bool Cache::give(void* ptr, size_t byte) noexcept {
+    const size_t index = bin(byte);
+    if(index >= BINS) {
+        return false; // not cacheable
+    }
+
+    std::lock_guard<core::Spin> guard(lock);
+    if(bytes.load(std::memory_order_relaxed) + byte > max.load(std::memory_order_relaxed)) {
+        return false; // full
+    }
+
+    Node* node  = new(ptr) Node;
+    node->next  = bins[index];
+    bins[index] = node;
+    bytes.fetch_add(byte, std::memory_order_relaxed);
+    return true;
+}
+
+inline size_t Cache::trim(size_t byte) noexcept {
+    size_t out = 0;
+    for(size_t i = BINS; i-- > 0 && (byte == 0 || out < byte);) {
+        const size_t size = BASE << i;
+        while(byte == 0 || out < byte) {
+            Node* node;
+            {
+                std::lock_guard<core::Spin> guard(lock);
+                node = bins[i];
+                if(!node) {
+                    break; // next bin
+                }
+                bins[i] = node->next;
+                bytes.fetch_sub(size, std::memory_order_relaxed);
+            }
+            global::pal_vfree(node, size); // syscall out of lock
+            out += size;
+        }
+    }
+    return out;
+}
+
+inline void Cache::limit(size_t byte) noexcept {
+    max.store(byte, std::memory_order_relaxed);
+
+    const size_t now = bytes.load(std::memory_order_relaxed);
+    if(now > byte) {
+        trim(now - byte);
+    }
+}
+
+inline size_t Cache::size() noexcept {
+    return bytes.load(std::memory_order_relaxed);
+}
+
+inline size_t Cache::bin(size_t byte) noexcept {
+    if(byte < BASE || !global::bit_aligned(byte)) {
+        return BINS; // not power of 2 chunk
+    }
+    return size_t(global::bit_log2(byte) - global::bit_log2(BASE));
+}
@@ -0,0 +1,177 @@
+#ifndef MEM_EPOCH_HPP
+#define MEM_EPOCH_HPP
+
+#include "../core/spin.hpp"
+#include "malloc.hpp"
+#include <atomic>
+#include <mutex>
+
+/**
+ * @brief epoch based reclamation domain, retired blocks are released in batch after grace period
+ * @note  readers are wait-free: pin stores epoch and a fence, retire is per thread and lock-free
+ *
+ * [usage]
+ * Epoch         domain;                  // default sink: Malloc::local()
+ * Epoch         raw(allocator);          // or batch release of an Allocator or Shared instance
+ * Epoch         objs(Epoch::batch<Node, Pool<Node>>, &pool); // or as Node by Pool
+ * Epoch::Local* local = domain.join();   // once per thread
+ * {
+ *     Epoch::Guard guard = local->pin(); // read shared nodes
+ *     ...
+ *     local->retire(node);               // unlinked node, released 2 epochs later
+ * }
+ * domain.leave(local);                   // before thread exit
+ */
+class Epoch {
+public:
+    /**
+     * @brief batch release of matured bucket, called on the thread of retire or collect
+     *
+     * @param [in] ctx  context given to constructor, e.g. owner of blocks
+     * @param [in] ptrs retired blocks
+     * @param [in] cnt  block count
+     */
+    using Sink = void (*)(void* ctx, void* const* ptrs, size_t cnt);
+
+public:
+    class Local; //!< per thread participant
+    class Guard; //!< pinned section
+
+private:
+    struct Bag; //!< retired block bucket
+
+public:
+    /**
+     * @param [in] sink OPTIONAL: batch release, nullptr is Malloc::local()
+     * @param [in] ctx  OPTIONAL: passed to sink
+     */
+    explicit Epoch(Sink sink = nullptr, void* ctx = nullptr) noexcept;
+
+public:
+    /**
+     * @brief blocks are handed back to owner by its batch release(T* const*, size_t)
+     * @note  owner must outlive domain, and accept release from thread of retire or collect
+     *
+     * @param [in] owner e.g. Allocator, Shared
+     */
+    template<typename A> explicit Epoch(A& owner) noexcept;
+
+public:
+    /**
+     * @brief sink calling release(T* const*, size_t) of owner A given as ctx, at most one bucket per call
+     * @note  owner must outlive domain, and accept release from thread of retire or collect
+     */
+    template<typename T, typename A> static void batch(void* ctx, void* const* ptrs, size_t cnt);
+
+public:
+    /**
+     * @brief release all retired blocks, every Local must be left
+     */
+    ~Epoch();
+
+public:
+    /**
+     * @brief register calling thread, Local of left thread is reused
+     * @return nullptr if failed
+     */
+    Local* join() noexcept;
+
+public:
+    /**
+     * @brief unregister, retired blocks not matured are moved to domain and released by collect
+     */
+    void leave(Local* in) noexcept;
+
+public:
+    /**
+     * @brief try advance epoch, and release matured blocks left by threads
+     * @return released blocks count
+     */
+    size_t collect() noexcept;
+
+public:
+    /**
+     * @brief current global epoch
+     */
+    uint64_t epoch() const noexcept;
+
+private:
+    //! @brief advance if every pinned thread observed current epoch
+    bool advance() noexcept;
+
+private:
+    //! @brief release matured bags of queue, return released count
+    size_t release(Bag*& head, Bag*& tail, uint64_t now) noexcept;
+
+private:
+    std::atomic<uint64_t> global{ 2 };      //!< epoch, starts at 2 for no underflow
+    std::atomic<Local*>   locals{ nullptr }; //!< participants, append only
+    Sink                  sink;
+    void*                 ctx; //!< of sink
+
+private:
+    core::Spin lock;           //!< orphans lock
+    Bag*       head = nullptr; //!< orphans: oldest
+    Bag*       tail = nullptr; //!< orphans: newest
+};
+
+//! @brief per thread participant, used by owner thread only
+class Epoch::Local {
+    friend class Epoch;
+
+public:
+    /**
+     * @brief enter read section, wait-free, nestable
+     */
+    Guard pin() noexcept;
+
+public:
+    /**
+     * @brief defer release until no pinned thread can hold ptr
+     *
+     * @param [in] ptr unlinked block, not reachable by new readers
+     */
+    void retire(void* ptr) noexcept;
+
+public:
+    /**
+     * @brief try advance epoch, and release matured blocks of this thread
+     * @return released blocks count
+     */
+    size_t flush() noexcept;
+
+private:
+    Local(Epoch* domain) noexcept;
+
+private:
+    void unpin() noexcept;
+
+private:
+    std::atomic<uint64_t> state{ 0 };    //!< epoch << 1 | pinned
+    std::atomic<bool>     used{ true };  //!< joined
+    Local*                next = nullptr; //!< immutable after published
+    Epoch*                domain;
+    uint32_t              depth = 0;       //!< nested pin
+    Bag*                  head  = nullptr; //!< retired: oldest
+    Bag*                  tail  = nullptr; //!< retired: newest
+};
+
+//! @brief scoped pin
+class Epoch::Guard {
+    friend class Local;
+
+public:
+    Guard(Guard&& in) noexcept;
+
+public:
+    ~Guard();
+
+private:
+    Guard(Local* local) noexcept;
+
+private:
+    Local* local;
+};
+
+#include "epoch.ipp"
+#endif
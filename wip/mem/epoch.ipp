@@ -0,0 +1,186 @@
+#ifndef MEM_EPOCH_HPP
+#    include "epoch.hpp"
+#endif
+
+struct Epoch::Bag {
+    static constexpr size_t SIZE = 62; //!< 512 bytes bag
+
+    Bag*     next;
+    uint64_t epoch;  //!< latest retire epoch
+    size_t   cnt;
+    void*    ptr[SIZE];
+};
+
+inline Epoch::Epoch(Sink in, void* arg) noexcept: sink(in), ctx(arg) {
+    if(!sink) {
+        sink = [](void*, void* const* ptrs, size_t cnt) { Malloc::local().release(ptrs, cnt); };
+    }
+}
+
+template<typename A> Epoch::Epoch(A& owner) noexcept: sink(batch<void, A>), ctx(&owner) { }
+
+template<typename T, typename A> void Epoch::batch(void* ctx, void* const* ptrs, size_t cnt) {
+    if constexpr(std::is_same_v<T, void>) {
+        static_cast<A*>(ctx)->release(ptrs, cnt);
+    }
+    else {
+        T* objs[Bag::SIZE]; // typed copy of one bucket
+        for(size_t i = 0; i < cnt; ++i) {
+            objs[i] = static_cast<T*>(ptrs[i]);
+        }
+        static_cast<A*>(ctx)->release(static_cast<T* const*>(objs), cnt);
+    }
+}
+
+inline Epoch::~Epoch() {
+    const uint64_t END = ~uint64_t(0); // everything is matured
+
+    Local* curr = locals.load(std::memory_order_acquire);
+    while(curr) {
+        Local* next = curr->next;
+        release(curr->head, curr->tail, END);
+        curr->~Local();
+        std::free(curr);
+        curr = next;
+    }
+    release(head, tail, END);
+}
+
+inline auto Epoch::join() noexcept -> Local* {
+    // reuse
+    for(Local* curr = locals.load(std::memory_order_acquire); curr; curr = curr->next) {
+        bool expect = false;
+        if(curr->used.compare_exchange_strong(expect, true, std::memory_order_acquire)) {
+            return curr;
+        }
+    }
+
+    void* mem = std::malloc(sizeof(Local));
+    if(!mem) {
+        return nullptr; // failed
+    }
+    Local* out = new(mem) Local(this);
+
+    // publish
+    out->next = locals.load(std::memory_order_relaxed);
+    while(!locals.compare_exchange_weak(out->next, out, std::memory_order_release, std::memory_order_relaxed)) { }
+    return out;
+}
+
+inline void Epoch::leave(Local* in) noexcept {
+    in->flush();
+
+    // hand over not matured
+    if(in->head) {
+        std::lock_guard<core::Spin> guard(lock);
+        if(tail) {
+            tail->next = in->head;
+        }
+        else head = in->head;
+        tail = in->tail;
+    }
+    in->head = nullptr;
+    in->tail = nullptr;
+    in->state.store(0, std::memory_order_release);
+    in->used.store(false, std::memory_order_release);
+}
+
+inline size_t Epoch::collect() noexcept {
+    advance();
+
+    std::lock_guard<core::Spin> guard(lock);
+    return release(head, tail, global.load(std::memory_order_acquire));
+}
+
+inline uint64_t Epoch::epoch() const noexcept {
+    return global.load(std::memory_order_acquire);
+}
+
+inline bool Epoch::advance() noexcept {
+    uint64_t now = global.load(std::memory_order_seq_cst);
+
+    for(Local* curr = locals.load(std::memory_order_acquire); curr; curr = curr->next) {
+        const uint64_t state = curr->state.load(std::memory_order_seq_cst);
+        if((state & 1) && (state >> 1) != now) {
+            return false; // pinned in previous epoch
+        }
+    }
+    return global.compare_exchange_strong(now, now + 1, std::memory_order_seq_cst);
+}
+
+inline size_t Epoch::release(Bag*& first, Bag*& last, uint64_t now) noexcept {
+    size_t cnt = 0;
+
+    // blocks retired in epoch e are unreachable by pins of e + 2
+    while(first && (now == ~uint64_t(0) || first->epoch + 2 <= now)) {
+        Bag* next = first->next;
+        sink(ctx, first->ptr, first->cnt); // batch
+        cnt += first->cnt;
+        std::free(first);
+        first = next;
+    }
+    if(!first) {
+        last = nullptr;
+    }
+    return cnt;
+}
+
+inline Epoch::Local::Local(Epoch* in) noexcept: domain(in) { }
+
+inline auto Epoch::Local::pin() noexcept -> Guard {
+    if(depth++ == 0) {
+        const uint64_t now = domain->global.load(std::memory_order_relaxed);
+        state.store((now << 1) | 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // publish before reading shared nodes
+    }
+    return Guard(this);
+}
+
+inline void Epoch::Local::unpin() noexcept {
+    if(--depth == 0) {
+        state.store(0, std::memory_order_release);
+    }
+}
+
+inline void Epoch::Local::retire(void* ptr) noexcept {
+    const uint64_t now = domain->global.load(std::memory_order_acquire);
+
+    // new bag
+    if(!tail || tail->cnt == Bag::SIZE) {
+        if(tail) {
+            flush(); // bag filled, amortized
+        }
+
+        Bag* bag = static_cast<Bag*>(std::malloc(sizeof(Bag)));
+        if(!bag) {
+            std::abort(); // out of memory, cannot release before grace period
+        }
+        bag->next = nullptr;
+        bag->cnt  = 0;
+        if(tail) {
+            tail->next = bag;
+        }
+        else head = bag;
+        tail = bag;
+    }
+
+    tail->epoch            = now;
+    tail->ptr[tail->cnt++] = ptr;
+}
+
+inline size_t Epoch::Local::flush() noexcept {
+    domain->advance();
+    return domain->release(head, tail, domain->global.load(std::memory_order_acquire));
+}
+
+inline Epoch::Guard::Guard(Local* in) noexcept: local(in) { }
+
+inline Epoch::Guard::Guard(Guard&& in) noexcept: local(in.local) {
+    in.local = nullptr;
+}
+
+inline Epoch::Guard::~Guard() {
+    if(local) {
+        local->unpin();
+    }
+}
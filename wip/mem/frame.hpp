@@ -0,0 +1,39 @@
+#ifndef MEM_FRAME_HPP
+#define MEM_FRAME_HPP
+
+#include "malloc.hpp"
+#include <new>
+
+/**
+ * @brief coroutine promise mixin, frame is allocated by size class of Malloc::local()
+ * @note  elided frame (HALO) calls neither operator, frame destroyed on other thread is a remote free
+ *
+ * [usage]
+ * struct promise_type : Frame { ... };
+ */
+class Frame {
+public:
+    /**
+     * @throw std::bad_alloc if failed, noexcept form is selected by get_return_object_on_allocation_failure
+     */
+    static void* operator new(size_t byte) {
+        void* out = Malloc::local().acquire(byte);
+        if(!out) {
+            throw std::bad_alloc();
+        }
+        return out;
+    }
+
+public:
+    static void* operator new(size_t byte, const std::nothrow_t&) noexcept {
+        return Malloc::local().acquire(byte);
+    }
+
+public:
+    //! @brief sized, frame size is known to compiler
+    static void operator delete(void* ptr, size_t byte) noexcept {
+        Malloc::local().release(ptr, byte);
+    }
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef MEM_HEAP_HPP
+#define MEM_HEAP_HPP
+
+#include "../core/offset.hpp"
+#include "../core/spin.hpp"
+#include "../global/pal.hpp"
+#include "../global/num.hpp"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+
+/**
+ * @brief file or shared memory backed chunk source, placed at the beginning of its own mapping
+ * @note  every link inside the mapping must be core::Offset to survive a remap at another base,
+ *        map and unmap are locked by address free spin lock, so one heap can be mapped by processes
+ *
+ * [memory layout]
+ * +------+-------+-------+-------+-----+
+ * | Heap | chunk | chunk | chunk | ... |
+ * +------+-------+-------+-------+-----+
+ * ^      ^
+ * base   aligned to chunk size
+ *
+ * [usage]
+ * Heap*       heap = Heap::open("pool.bin", 1 << 30);
+ * Pool<Node>* pool = heap->root<Pool<Node>>(0, heap); // constructed once, found on restart
+ * ...
+ * Heap::close(heap); // flush and unmap, objects in pool are kept
+ *
+ * Heap* heap = Heap::share("/queue", 1 << 30); // first process creates, others attach
+ */
+class Heap {
+public:
+    static constexpr size_t   ROOTS = 16;                    //!< root object slot count
+    static constexpr uint64_t MAGIC = 0x315041454857454Cull; //!< "LWEHEAP1" little endian
+
+public:
+    /**
+     * @brief map file, create heap if file is new, or restore
+     *
+     * @param [in] path  file path
+     * @param [in] byte  file size, ignored when file has heap already
+     * @param [in] base  OPTIONAL: fixed address, nullptr is relocatable
+     * @param [in] align mapping alignment, chunks larger than this cannot be mapped
+     * @return nullptr if failed or file is not heap
+     */
+    static Heap* open(const char* path, size_t byte, void* base = nullptr, size_t align = global::PAL_HUGEPAGE) noexcept;
+
+public:
+    /**
+     * @brief map shared memory segment, create heap if segment is new, or attach
+     *
+     * @param [in] name  segment name, POSIX name starts with '/'
+     * @param [in] byte  segment size, ignored when segment has heap already
+     * @param [in] base  OPTIONAL: fixed address, nullptr is relocatable
+     * @param [in] align mapping alignment, chunks larger than this cannot be mapped
+     * @return nullptr if failed or creator did not finish construction
+     */
+    static Heap* share(const char* name, size_t byte, void* base = nullptr, size_t align = global::PAL_HUGEPAGE) noexcept;
+
+public:
+    /**
+     * @brief flush and unmap, does not call destructors of root objects
+     *
+     * @param [in] heap heap from open
+     */
+    static void close(Heap* heap) noexcept;
+
+public:
+    /**
+     * @brief write back dirty pages
+     * @return false if failed
+     */
+    bool flush() noexcept;
+
+public:
+    /**
+     * @brief carve a range, freed range of same size is reused first
+     *
+     * @param [in] byte  range size
+     * @param [in] align address alignment, up to mapping alignment
+     * @return nullptr if out of space
+     */
+    void* map(size_t byte, size_t align) noexcept;
+
+public:
+    /**
+     * @brief return a range
+     *
+     * @param [in] ptr  pointer from map
+     * @param [in] byte same size used when calling map
+     */
+    void unmap(void* ptr, size_t byte) noexcept;
+
+public:
+    /**
+     * @brief get or construct persistent root object
+     *
+     * @tparam T    root object type
+     * @param [in] slot index, less than ROOTS
+     * @param [in] args constructor parameters, used at first call only
+     * @return nullptr if failed or size of T differs from stored object
+     */
+    template<typename T, typename... Args> T* root(size_t slot, Args&&... args) noexcept;
+
+public:
+    /**
+     * @brief get remained carvable bytes, freed ranges are not counted
+     */
+    size_t remain() const noexcept;
+
+public:
+    /**
+     * @brief pointer to mapping independent position, to hand over to other process
+     *
+     * @param [in] ptr pointer in this heap
+     * @return distance from heap, 0 if nullptr
+     */
+    uint64_t offset(const void* ptr) const noexcept;
+
+public:
+    /**
+     * @brief mapping independent position to pointer
+     *
+     * @tparam T type of the returned pointer
+     * @param [in] pos distance from heap
+     * @return nullptr if 0 or out of heap
+     */
+    template<typename T = void> T* resolve(uint64_t pos) const noexcept;
+
+private:
+    Heap(size_t byte, size_t align) noexcept;
+
+private:
+    //! @brief map without lock
+    void* carve(size_t byte, size_t align) noexcept;
+
+private:
+    //! @brief freed range header, single linked list
+    struct Free {
+        core::Offset<Free> next; //!< next freed range
+        size_t             byte; //!< range size
+    };
+
+private:
+    static constexpr size_t WAIT = 1 << 24; //!< spin count to wait for creator
+
+private:
+    std::atomic<uint64_t> magic;  //!< file check, stored last when created
+    uint64_t              byte;   //!< mapping size
+    uint64_t              align;  //!< mapping alignment
+    uint64_t              cursor; //!< carve position from base
+    core::Spin            lock;   //!< map, unmap, root lock
+
+private:
+    core::Offset<Free> frees;        //!< freed range list
+    core::Offset<void> roots[ROOTS]; //!< root objects
+    uint64_t           sizes[ROOTS]; //!< root object sizes
+};
+
+#include "heap.ipp"
+#endif
@@ -0,0 +1,169 @@
+#ifndef MEM_HEAP_HPP
+#    include "heap.hpp"
+#endif
+
+inline Heap::Heap(size_t byte, size_t align) noexcept:
+    byte(byte), align(align), cursor(global::num_align(sizeof(Heap), global::PAL_PAGE)), sizes{} {
+    magic.store(MAGIC, std::memory_order_release); // publish to attaching processes
+}
+
+inline Heap* Heap::open(const char* path, size_t byte, void* base, size_t align) noexcept {
+    align = global::bit_pow2(align);
+
+    Heap* heap = static_cast<Heap*>(global::pal_fmap(path, byte, align, base));
+    if(!heap) {
+        return nullptr; // failed
+    }
+
+    // new file: zero filled
+    if(heap->magic.load(std::memory_order_acquire) == 0) {
+        return new(heap) Heap(global::bit_align(byte, global::PAL_PAGE), align);
+    }
+
+    // not heap
+    if(heap->magic.load(std::memory_order_acquire) != MAGIC || heap->align > align) {
+        global::pal_funmap(heap, byte);
+        return nullptr;
+    }
+
+    // stored size differs: remap
+    if(heap->byte != global::bit_align(byte, global::PAL_PAGE)) {
+        size_t stored = size_t(heap->byte);
+        global::pal_funmap(heap, byte);
+        heap = static_cast<Heap*>(global::pal_fmap(path, stored, align, base));
+    }
+
+    // lock holder is gone
+    if(heap) {
+        heap->lock.unlock();
+    }
+    return heap;
+}
+
+inline Heap* Heap::share(const char* name, size_t byte, void* base, size_t align) noexcept {
+    align = global::bit_pow2(align);
+
+    bool  created = false;
+    Heap* heap    = static_cast<Heap*>(global::pal_smap(name, byte, &created, align, base));
+    if(!heap) {
+        return nullptr; // failed
+    }
+
+    // new segment: zero filled
+    if(created) {
+        return new(heap) Heap(global::bit_align(byte, global::PAL_PAGE), align);
+    }
+
+    // wait for creator
+    for(size_t i = 0; heap->magic.load(std::memory_order_acquire) != MAGIC; ++i) {
+        if(i >= WAIT) {
+            global::pal_funmap(heap, byte);
+            return nullptr; // not heap or creator is gone
+        }
+        global::pal_pause();
+    }
+
+    // check layout
+    if(heap->align > align || heap->byte > global::bit_align(byte, global::PAL_PAGE)) {
+        size_t stored = size_t(heap->byte);
+        size_t need   = size_t(heap->align);
+        global::pal_funmap(heap, byte);
+        if(need > align) {
+            return nullptr; // cannot be aligned
+        }
+        heap = static_cast<Heap*>(global::pal_smap(name, stored, nullptr, align, base)); // larger segment
+    }
+    return heap;
+}
+
+inline void Heap::close(Heap* heap) noexcept {
+    if(!heap) return;
+
+    size_t byte = size_t(heap->byte);
+    heap->flush();
+    global::pal_funmap(heap, byte);
+}
+
+inline bool Heap::flush() noexcept {
+    return global::pal_fsync(this, size_t(byte));
+}
+
+inline void* Heap::map(size_t byte, size_t align) noexcept {
+    if(!global::bit_aligned(align) || align > this->align) {
+        return nullptr; // invalid alignment
+    }
+    std::lock_guard<core::Spin> guard(lock);
+    return carve(byte, align);
+}
+
+inline void* Heap::carve(size_t byte, size_t align) noexcept {
+    // first: reuse freed range of same size
+    for(core::Offset<Free>* link = &frees; *link; link = &(*link)->next) {
+        Free* free = *link;
+        if(free->byte == byte && global::bit_aligned(uint64_t(free), align)) {
+            *link = free->next.get(); // unlink
+            free->~Free();
+            return free;
+        }
+    }
+
+    // second: carve
+    uint64_t begin = global::num_align(size_t(cursor), align);
+    if(begin > this->byte || byte > this->byte - begin) {
+        return nullptr; // out of space
+    }
+    cursor = begin + byte;
+
+    return reinterpret_cast<uint8_t*>(this) + begin;
+}
+
+inline void Heap::unmap(void* ptr, size_t byte) noexcept {
+    if(!ptr) return;
+    std::lock_guard<core::Spin> guard(lock);
+
+    Free* free = new(ptr) Free;
+    free->byte = byte;
+    free->next = frees.get(); // push front
+    frees      = free;
+}
+
+template<typename T, typename... Args> T* Heap::root(size_t slot, Args&&... args) noexcept {
+    if(slot >= ROOTS) {
+        return nullptr; // invalid
+    }
+    std::lock_guard<core::Spin> guard(lock);
+
+    // restore
+    if(roots[slot]) {
+        if(sizes[slot] != sizeof(T)) {
+            return nullptr; // type mismatch
+        }
+        return std::launder(static_cast<T*>(roots[slot].get()));
+    }
+
+    // create
+    void* ptr = carve(global::num_align(sizeof(T), alignof(T)), alignof(T) > sizeof(void*) ? alignof(T) : sizeof(void*));
+    if(!ptr) {
+        return nullptr; // out of space
+    }
+    T* out = new(ptr) T(std::forward<Args>(args)...);
+
+    roots[slot] = ptr;
+    sizes[slot] = sizeof(T);
+    return out;
+}
+
+inline size_t Heap::remain() const noexcept {
+    return size_t(byte - cursor);
+}
+
+inline uint64_t Heap::offset(const void* ptr) const noexcept {
+    return ptr ? uint64_t(reinterpret_cast<const uint8_t*>(ptr) - reinterpret_cast<const uint8_t*>(this)) : 0;
+}
+
+template<typename T> T* Heap::resolve(uint64_t pos) const noexcept {
+    if(pos == 0 || pos >= byte) {
+        return nullptr; // null or out of heap
+    }
+    return reinterpret_cast<T*>(const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(this)) + pos);
+}
@@ -0,0 +1,126 @@
+#ifndef MEM_LATENCY_HPP
+#define MEM_LATENCY_HPP
+
+#include "../global/pal.hpp"
+#include <cstdint>
+
+/**
+ * @brief per-thread log-linear latency histogram of acquire / release, unit is pal_tick
+ * @note  enabled by MEM_LATENCY, the sampling period, e.g. -DMEM_LATENCY=1 samples every call
+ *
+ * [bucket]
+ * 0 ~ 7 : 1 tick step
+ * 8 ~   : 8 steps per power of 2, error under 12.5%
+ */
+class Latency {
+public:
+    static constexpr size_t MINOR  = 8;              //!< linear steps per power of 2
+    static constexpr size_t MAJOR  = 32;             //!< power of 2 count, up to 2^34 ticks
+    static constexpr size_t BUCKET = MAJOR * MINOR; //!< bucket count
+
+public:
+    //! @brief sampled call
+    enum class Op : uint8_t {
+        ACQUIRE,
+        RELEASE,
+    };
+
+public:
+    //! @brief slowest path taken in the call
+    enum class Path : uint8_t {
+        FAST,    //!< block from current chunk, release without list move
+        SWITCH,  //!< current chunk retired to list, release with list move
+        RECYCLE, //!< chunk popped from partial or full
+        SYSCALL, //!< chunk generated
+    };
+
+public:
+    //! @brief percentiles, upper bound of bucket
+    struct Report {
+        uint64_t count;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t p9999;
+    };
+
+public:
+    class Probe; //!< scoped sampler
+
+public:
+    /**
+     * @param [in] tick latency
+     * @return bucket index, clamped to last
+     */
+    static constexpr size_t bucket(uint64_t tick) noexcept;
+
+public:
+    /**
+     * @param [in] index bucket index
+     * @return max tick of bucket
+     */
+    static constexpr uint64_t bound(size_t index) noexcept;
+
+public:
+    /**
+     * @brief add a sample
+     */
+    void record(Op op, Path path, uint64_t tick) noexcept;
+
+public:
+    /**
+     * @param [in] rate 0.0 ~ 1.0, e.g. 0.999
+     * @return upper bound tick of the bucket containing the rate, 0 if empty
+     */
+    uint64_t percentile(Op op, Path path, double rate) const noexcept;
+
+public:
+    /**
+     * @return p50 ~ p99.99
+     */
+    Report report(Op op, Path path) const noexcept;
+
+public:
+    /**
+     * @brief add other histograms, e.g. to aggregate threads
+     */
+    void merge(const Latency& in) noexcept;
+
+public:
+    /**
+     * @brief reset all histograms
+     */
+    void clear() noexcept;
+
+private:
+    uint64_t count[2][4][BUCKET] = {}; //!< [op][path][bucket]
+};
+
+//! @brief record on scope exit with the slowest tagged path, no-op if MEM_LATENCY is 0 or not sampled
+class Latency::Probe {
+public:
+    /**
+     * @param [in] get thread local histogram getter, called only if sampled, nullptr is not sampled
+     * @param [in] op  sampled call
+     */
+    Probe(Latency& (*get)(), Op op) noexcept;
+
+public:
+    ~Probe();
+
+public:
+    /**
+     * @brief mark path, slower path wins
+     */
+    void tag(Path in) noexcept;
+
+private:
+    Latency* owner = nullptr; //!< nullptr if not sampled
+    uint64_t begin = 0;
+    Op       op    = Op::ACQUIRE;
+    Path     path  = Path::FAST;
+};
+
+#include "latency.ipp"
+#endif
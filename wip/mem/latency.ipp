@@ -0,0 +1,107 @@
+#ifndef MEM_LATENCY_HPP
+#    include "latency.hpp"
+#endif
+
+constexpr size_t Latency::bucket(uint64_t tick) noexcept {
+    if(tick < MINOR) {
+        return size_t(tick); // linear
+    }
+    const size_t log   = size_t(63 - global::bit_clz(tick));     // floor(log2(tick)), 3 ~
+    const size_t index = (log - 2) * MINOR + ((tick >> (log - 3)) & (MINOR - 1)); // power + step
+    return index < BUCKET ? index : BUCKET - 1;
+}
+
+constexpr uint64_t Latency::bound(size_t index) noexcept {
+    if(index < MINOR) {
+        return index;
+    }
+    const size_t log = index / MINOR + 2;
+    return ((MINOR + index % MINOR + 1) << (log - 3)) - 1; // next lower bound - 1
+}
+
+inline void Latency::record(Op op, Path path, uint64_t tick) noexcept {
+    ++count[size_t(op)][size_t(path)][bucket(tick)];
+}
+
+inline uint64_t Latency::percentile(Op op, Path path, double rate) const noexcept {
+    const uint64_t* hist = count[size_t(op)][size_t(path)];
+
+    uint64_t total = 0;
+    for(size_t i = 0; i < BUCKET; ++i) {
+        total += hist[i];
+    }
+    if(total == 0) {
+        return 0; // empty
+    }
+
+    // rank, at least 1
+    uint64_t rank = uint64_t(rate * double(total) + 0.5);
+    if(rank == 0) rank = 1;
+
+    uint64_t sum = 0;
+    for(size_t i = 0; i < BUCKET; ++i) {
+        sum += hist[i];
+        if(sum >= rank) {
+            return bound(i);
+        }
+    }
+    return bound(BUCKET - 1);
+}
+
+inline auto Latency::report(Op op, Path path) const noexcept -> Report {
+    Report out = {};
+    for(const uint64_t& n : count[size_t(op)][size_t(path)]) {
+        out.count += n;
+    }
+    out.p50   = percentile(op, path, 0.5);
+    out.p90   = percentile(op, path, 0.9);
+    out.p99   = percentile(op, path, 0.99);
+    out.p999  = percentile(op, path, 0.999);
+    out.p9999 = percentile(op, path, 0.9999);
+    return out;
+}
+
+inline void Latency::merge(const Latency& in) noexcept {
+    for(size_t i = 0; i < 2; ++i) {
+        for(size_t j = 0; j < 4; ++j) {
+            for(size_t k = 0; k < BUCKET; ++k) {
+                count[i][j][k] += in.count[i][j][k];
+            }
+        }
+    }
+}
+
+inline void Latency::clear() noexcept {
+    *this = Latency();
+}
+
+inline Latency::Probe::Probe([[maybe_unused]] Latency& (*get)(), [[maybe_unused]] Op in) noexcept {
+    if constexpr(MEM_LATENCY != 0) {
+        static thread_local uint32_t skip = 0; // calls until next sample
+
+        if(!get) {
+            return; // disabled by policy
+        }
+        if(skip == 0) {
+            skip  = MEM_LATENCY - 1;
+            owner = &get();
+            op    = in;
+            begin = global::pal_tick();
+        }
+        else --skip;
+    }
+}
+
+inline Latency::Probe::~Probe() {
+    if constexpr(MEM_LATENCY != 0) {
+        if(owner) {
+            owner->record(op, path, global::pal_tick() - begin);
+        }
+    }
+}
+
+inline void Latency::Probe::tag(Path in) noexcept {
+    if(in > path) {
+        path = in; // slower
+    }
+}
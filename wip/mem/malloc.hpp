@@ -0,0 +1,149 @@
+#ifndef MEM_MALLOC_HPP
+#define MEM_MALLOC_HPP
+
+#include "allocator.hpp"
+#include "sizeclass.hpp"
+#include "tag.hpp"
+#include <tuple>
+#include <utility>
+
+/**
+ * @brief general purpose front-end, SizeClass by Allocator<N> and page mapped large blocks
+ * @note  not thread safe, use local() per thread, block released by other thread is queued as remote free
+ *
+ * over SizeClass::LARGE: own mapping, resized by pal_vremap
+ */
+class Malloc {
+public:
+    /**
+     * @param [in] byte request size
+     * @return nullptr if failed
+     */
+    void* acquire(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief acquire charged to tenant by usable size, size class block or large mapping
+     *
+     * @param [in] byte request size
+     * @param [in] tag  budget, checked before the size class
+     * @return nullptr if over budget or failed
+     */
+    void* acquire(size_t byte, Tag& tag) noexcept;
+
+public:
+    /**
+     * @brief size-free free by Pagemap, crash if not registered
+     * @note  callable from any thread, chunks of exited thread are adopted by next slow path
+     *
+     * @param [in] ptr pointer from acquire or reallocate
+     */
+    void release(void* ptr) noexcept;
+
+public:
+    /**
+     * @brief sized free, without Pagemap lookup for size classes
+     *
+     * @param [in] ptr  pointer from acquire or reallocate
+     * @param [in] byte same size used when calling acquire or reallocate
+     */
+    void release(void* ptr, size_t byte) noexcept;
+
+public:
+    /**
+     * @brief size-free free refunded to tenant, size by Pagemap
+     *
+     * @param [in] ptr pointer from acquire(byte, tag) of the same tag
+     * @param [in] tag budget charged by acquire
+     */
+    void release(void* ptr, Tag& tag) noexcept;
+
+public:
+    /**
+     * @brief batch size-free free, e.g. bucket of deferred reclamation
+     *
+     * @param [in] ptrs pointers from acquire or reallocate
+     * @param [in] cnt  pointer count
+     */
+    void release(void* const* ptrs, size_t cnt) noexcept;
+
+public:
+    /**
+     * @brief resize, large block is remapped in place or its pages are moved, others are moved by size class
+     *
+     * @param [in] ptr  pointer from any registered allocator, nullptr is acquire
+     * @param [in] byte new size, 0 is release
+     * @return nullptr if failed, ptr is kept then
+     */
+    void* reallocate(void* ptr, size_t byte) noexcept;
+
+public:
+    /**
+     * @brief syscall: keep unused chunks of every size class between watermarks
+     *
+     * @param [in] low  min unused chunk count per size class
+     * @param [in] high max unused chunk count per size class
+     * @return generated or destroyed chunks count
+     */
+    size_t maintain(size_t low, size_t high);
+
+public:
+    /**
+     * @brief syscall: discard free pages of partial chunks of every size class
+     *
+     * @param [in] lazy OPTIONAL: MADV_FREE instead of MADV_DONTNEED
+     * @return discarded bytes
+     */
+    size_t scavenge(bool lazy = false);
+
+public:
+    /**
+     * @brief thread local instance
+     */
+    static Malloc& local() noexcept;
+
+private:
+    template<size_t... I> static auto make(std::index_sequence<I...>) -> std::tuple<Allocator<SizeClass::block(I)>...>;
+
+private:
+    //! @brief size class dispatch
+    template<size_t... I> void* take(size_t index, std::index_sequence<I...>) noexcept;
+
+private:
+    //! @brief size class dispatch
+    template<size_t... I> void give(size_t index, void* ptr, std::index_sequence<I...>) noexcept;
+
+private:
+    //! @brief size class dispatch, batch
+    template<size_t... I> void give(size_t index, void* const* ptrs, size_t cnt, std::index_sequence<I...>) noexcept;
+
+private:
+    //! @brief size class dispatch, descriptor of table
+    template<size_t... I> static const Pagemap::Class* descriptor(size_t index, std::index_sequence<I...>) noexcept;
+
+private:
+    //! @brief size class fold
+    template<size_t... I> size_t maintain(size_t low, size_t high, std::index_sequence<I...>);
+
+private:
+    //! @brief size class fold
+    template<size_t... I> size_t scavenge(bool lazy, std::index_sequence<I...>);
+
+private:
+    //! @brief syscall: large block
+    void* map(size_t byte) noexcept;
+
+private:
+    //! @brief syscall: large block
+    static void unmap(void* ptr) noexcept;
+
+private:
+    //! @brief large block descriptor for Pagemap, block size is variable
+    static const Pagemap::Class LARGED;
+
+private:
+    decltype(make(std::make_index_sequence<SizeClass::COUNT>())) table; //!< size classes
+};
+
+#include "malloc.ipp"
+#endif
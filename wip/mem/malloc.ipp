@@ -0,0 +1,233 @@
+#ifndef MEM_MALLOC_HPP
+#    include "malloc.hpp"
+#endif
+
+inline void* Malloc::acquire(size_t byte) noexcept {
+    if(byte > SizeClass::LARGE) {
+        return map(byte);
+    }
+    return take(SizeClass::index(byte), std::make_index_sequence<SizeClass::COUNT>());
+}
+
+inline void* Malloc::acquire(size_t byte, Tag& tag) noexcept {
+    const size_t size = byte > SizeClass::LARGE ? global::pal_vsize(byte) : SizeClass::block(SizeClass::index(byte));
+    if(!tag.charge(size)) {
+        return nullptr; // over budget, before slow path
+    }
+
+    void* ptr = acquire(byte);
+    if(!ptr) {
+        tag.refund(size);
+    }
+    return ptr;
+}
+
+inline void Malloc::release(void* ptr) noexcept {
+    if(!ptr) return;
+
+    Pagemap::Entry* entry = Pagemap::find(ptr);
+    if(!entry) {
+        std::abort(); // not registered
+    }
+
+    // size class: by this thread, block of other thread is queued as remote free
+    const size_t block = entry->cls->block;
+    if(block && block <= SizeClass::LARGE &&
+       entry->cls == descriptor(SizeClass::index(block), std::make_index_sequence<SizeClass::COUNT>())) {
+        give(SizeClass::index(block), ptr, std::make_index_sequence<SizeClass::COUNT>());
+    }
+    else entry->cls->release(entry->owner, ptr); // large, or other allocator
+}
+
+inline void Malloc::release(void* const* ptrs, size_t cnt) noexcept {
+    size_t i = 0;
+    while(i < cnt) {
+        if(!ptrs[i]) {
+            ++i;
+            continue;
+        }
+
+        Pagemap::Entry* entry = Pagemap::find(ptrs[i]);
+        if(!entry) {
+            std::abort(); // not registered
+        }
+
+        // size class: run of same class is released by one batch
+        const size_t block = entry->cls->block;
+        if(block && block <= SizeClass::LARGE &&
+           entry->cls == descriptor(SizeClass::index(block), std::make_index_sequence<SizeClass::COUNT>())) {
+            size_t run = 1;
+            while(i + run < cnt && ptrs[i + run]) {
+                Pagemap::Entry* next = Pagemap::find(ptrs[i + run]);
+                if(!next || next->cls != entry->cls) break;
+                ++run;
+            }
+            give(SizeClass::index(block), ptrs + i, run, std::make_index_sequence<SizeClass::COUNT>());
+            i += run;
+        }
+        else {
+            entry->cls->release(entry->owner, ptrs[i]); // large, or other allocator
+            ++i;
+        }
+    }
+}
+
+inline void Malloc::release(void* ptr, size_t byte) noexcept {
+    if(!ptr) return;
+
+    if(byte > SizeClass::LARGE) {
+        unmap(ptr);
+    }
+    else give(SizeClass::index(byte), ptr, std::make_index_sequence<SizeClass::COUNT>());
+}
+
+inline void Malloc::release(void* ptr, Tag& tag) noexcept {
+    if(!ptr) return;
+
+    tag.refund(Pagemap::size(ptr));
+    release(ptr);
+}
+
+inline void* Malloc::reallocate(void* ptr, size_t byte) noexcept {
+    if(!ptr) {
+        return acquire(byte);
+    }
+    if(byte == 0) {
+        release(ptr);
+        return nullptr;
+    }
+
+    Pagemap::Entry* entry = Pagemap::find(ptr);
+    if(!entry) {
+        return nullptr; // not registered
+    }
+
+    const bool   large = entry->cls == &LARGED;
+    const size_t old   = large ? entry->slot : entry->cls->block;
+
+    // large to large: remap
+    if(large && byte > SizeClass::LARGE) {
+        const size_t next = global::pal_vsize(byte);
+        if(next == old) {
+            return ptr; // same mapping
+        }
+
+        void* moved = global::pal_vremap(ptr, old, next);
+        if(moved) {
+            Pagemap::erase(ptr, old);
+            if(Pagemap::insert(moved, next, this, &LARGED)) {
+                Pagemap::find(moved)->slot = next;
+                return moved;
+            }
+
+            // not registered, old mapping is gone: keep the data in a registered mapping
+            void* out = map(byte);
+            if(!out) {
+                std::abort(); // cannot register, unreachable in practice
+            }
+            std::memcpy(out, moved, old < byte ? old : byte);
+            global::pal_vfree(moved, next);
+            return out;
+        }
+        // not supported: copy
+    }
+
+    // size class: fits, and wastes less than half
+    else if(!large && byte <= old && byte > old / 2) {
+        return ptr;
+    }
+
+    // move
+    void* out = acquire(byte);
+    if(!out) {
+        return nullptr; // failed
+    }
+    std::memcpy(out, ptr, old < byte ? old : byte);
+    release(ptr);
+    return out;
+}
+
+inline size_t Malloc::maintain(size_t low, size_t high) {
+    return maintain(low, high, std::make_index_sequence<SizeClass::COUNT>());
+}
+
+inline size_t Malloc::scavenge(bool lazy) {
+    return scavenge(lazy, std::make_index_sequence<SizeClass::COUNT>());
+}
+
+inline Malloc& Malloc::local() noexcept {
+    static thread_local Malloc instance;
+    return instance;
+}
+
+template<size_t... I> void* Malloc::take(size_t index, std::index_sequence<I...>) noexcept {
+    using Take = void* (*)(Malloc*);
+
+    static constexpr Take TAKE[] = { [](Malloc* self) -> void* { return std::get<I>(self->table).acquire(); }... };
+    return TAKE[index](this);
+}
+
+template<size_t... I> void Malloc::give(size_t index, void* ptr, std::index_sequence<I...>) noexcept {
+    using Give = void (*)(Malloc*, void*);
+
+    static constexpr Give GIVE[] = { [](Malloc* self, void* in) { std::get<I>(self->table).release(in); }... };
+    GIVE[index](this, ptr);
+}
+
+template<size_t... I> void Malloc::give(size_t index, void* const* ptrs, size_t cnt, std::index_sequence<I...>) noexcept {
+    using Give = void (*)(Malloc*, void* const*, size_t);
+
+    static constexpr Give GIVE[] = { [](Malloc* self, void* const* in, size_t n) { std::get<I>(self->table).release(in, n); }... };
+    GIVE[index](this, ptrs, cnt);
+}
+
+template<size_t... I> const Pagemap::Class* Malloc::descriptor(size_t index, std::index_sequence<I...>) noexcept {
+    static constexpr const Pagemap::Class* CLASS[] = { &std::tuple_element_t<I, decltype(table)>::CLASS... };
+    return CLASS[index];
+}
+
+template<size_t... I> size_t Malloc::maintain(size_t low, size_t high, std::index_sequence<I...>) {
+    return (std::get<I>(table).maintain(low, high) + ...);
+}
+
+template<size_t... I> size_t Malloc::scavenge(bool lazy, std::index_sequence<I...>) {
+    return (std::get<I>(table).scavenge(~size_t(0), lazy) + ...);
+}
+
+inline void* Malloc::map(size_t byte) noexcept {
+    byte = global::pal_vsize(byte);
+
+    void* ptr = global::pal_valloc(byte, global::PAL_BOUNDARY);
+    if(!ptr) {
+        return nullptr; // failed
+    }
+
+    // register for size-free release
+    if(!Pagemap::insert(ptr, byte, this, &LARGED)) {
+        global::pal_vfree(ptr, byte);
+        return nullptr; // address out of range
+    }
+    Pagemap::find(ptr)->slot = byte;
+    return ptr;
+}
+
+inline void Malloc::unmap(void* ptr) noexcept {
+    Pagemap::Entry* entry = Pagemap::find(ptr);
+    if(!entry || entry->cls != &LARGED || entry->base != ptr) {
+        std::abort(); // not large block
+    }
+
+    const size_t byte = entry->slot;
+    Pagemap::erase(ptr, byte);
+    global::pal_vfree(ptr, byte);
+}
+
+inline const Pagemap::Class Malloc::LARGED = {
+    0,
+    0,
+    [](void*, void* ptr) { Malloc::unmap(ptr); },
+    [](void*, const void* ptr) {
+        const Pagemap::Entry* entry = Pagemap::find(ptr);
+        return entry && entry->base == ptr;
+    },
+};
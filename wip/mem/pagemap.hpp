@@ -0,0 +1,106 @@
+#ifndef MEM_PAGEMAP_HPP
+#define MEM_PAGEMAP_HPP
+
+#include "../global/pal.hpp"
+#include <atomic>
+
+/**
+ * @brief process wide two level radix tree, address to chunk, size class and owner allocator
+ * @note  key is address / 64KiB (chunk alignment), leaves are allocated on demand and never freed,
+ *        chunks carved from Heap are not registered because other processes and runs cannot see them
+ *
+ * [key]
+ * +--------+------------+-----------+------------------+
+ * | unused | ROOT  bits | LEAF bits | SHIFT bits       |
+ * +--------+------------+-----------+------------------+
+ * ^ 64     ^ BITS                   ^ 16               ^ 0
+ */
+class Pagemap {
+public:
+    static constexpr size_t SHIFT = 16;                               //!< log2(PAL_BOUNDARY)
+    static constexpr size_t BITS  = TARGET_BITS == BITS_64 ? 48 : 32; //!< virtual address bits
+    static constexpr size_t LEAF  = (BITS - SHIFT) / 2;               //!< leaf index bits
+    static constexpr size_t ROOT  = BITS - SHIFT - LEAF;              //!< root index bits
+
+public:
+    //! @brief size class descriptor, one per allocator type
+    struct Class {
+        size_t block;                                //!< usable size, 0 is variable: Entry::slot
+        size_t chunk;                                //!< chunk size
+        void (*release)(void* owner, void* ptr);     //!< size-free release
+        bool (*check)(void* owner, const void* ptr); //!< live block check
+    };
+
+public:
+    //! @brief per 64KiB page
+    struct Entry {
+        void*        base;  //!< chunk address
+        void*        owner; //!< allocator
+        const Class* cls;   //!< size class
+        size_t       slot;  //!< owner data, WHOLE: 1 + index in used vector, 0 is free, variable: size
+    };
+
+public:
+    /**
+     * @brief register chunk, every 64KiB page in range points the same chunk
+     *
+     * @param [in] base  chunk address, aligned to 64KiB
+     * @param [in] byte  chunk size
+     * @param [in] owner allocator
+     * @param [in] cls   size class of owner
+     * @return false if address is out of range or leaf allocation failed
+     */
+    static bool insert(void* base, size_t byte, void* owner, const Class* cls) noexcept;
+
+public:
+    /**
+     * @brief unregister chunk
+     *
+     * @param [in] base chunk address
+     * @param [in] byte same size used when calling insert
+     */
+    static void erase(void* base, size_t byte) noexcept;
+
+public:
+    /**
+     * @param [in] ptr any address
+     * @return entry of chunk containing ptr, nullptr if not registered
+     */
+    static Entry* find(const void* ptr) noexcept;
+
+public:
+    /**
+     * @brief size-free free, destructor is not called
+     *
+     * @param [in] ptr pointer from acquire of any registered allocator
+     * @return false if not registered
+     */
+    static bool release(void* ptr) noexcept;
+
+public:
+    /**
+     * @param [in] ptr any address
+     * @return block size of size class or variable size, 0 if not registered
+     */
+    static size_t size(const void* ptr) noexcept;
+
+public:
+    /**
+     * @param [in] ptr any address
+     * @return true if ptr is begin of live block
+     */
+    static bool check(const void* ptr) noexcept;
+
+private:
+    //! @brief leaf node
+    struct Leaf {
+        Entry entries[size_t(1) << LEAF];
+    };
+
+private:
+    //! @brief root node, zero initialized
+    static inline std::atomic<Leaf*> root[size_t(1) << ROOT];
+};
+
+#include "pagemap.ipp"
+#endif
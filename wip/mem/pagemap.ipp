@@ -0,0 +1,85 @@
+#ifndef MEM_PAGEMAP_HPP
+#    include "pagemap.hpp"
+#endif
+
+inline bool Pagemap::insert(void* base, size_t byte, void* owner, const Class* cls) noexcept {
+    const uintptr_t begin = uintptr_t(base) >> SHIFT;
+    const uintptr_t end   = (uintptr_t(base) + byte - 1) >> SHIFT;
+
+    if((end >> LEAF) >= (uintptr_t(1) << ROOT)) {
+        return false; // out of range
+    }
+
+    for(uintptr_t key = begin; key <= end; ++key) {
+        std::atomic<Leaf*>& node = root[key >> LEAF];
+
+        Leaf* leaf = node.load(std::memory_order_acquire);
+        if(!leaf) {
+            // zero filled
+            Leaf* temp = global::pal_valloc<Leaf>(sizeof(Leaf));
+            if(!temp) {
+                erase(base, (key - begin) << SHIFT); // rollback
+                return false;
+            }
+
+            // other thread may create
+            if(node.compare_exchange_strong(leaf, temp, std::memory_order_acq_rel)) {
+                leaf = temp;
+            }
+            else global::pal_vfree(temp, sizeof(Leaf));
+        }
+        leaf->entries[key & ((uintptr_t(1) << LEAF) - 1)] = Entry{ base, owner, cls, 0 };
+    }
+    return true;
+}
+
+inline void Pagemap::erase(void* base, size_t byte) noexcept {
+    if(byte == 0) return;
+
+    const uintptr_t begin = uintptr_t(base) >> SHIFT;
+    const uintptr_t end   = (uintptr_t(base) + byte - 1) >> SHIFT;
+
+    for(uintptr_t key = begin; key <= end; ++key) {
+        Leaf* leaf = root[key >> LEAF].load(std::memory_order_acquire);
+        if(leaf) {
+            leaf->entries[key & ((uintptr_t(1) << LEAF) - 1)] = Entry{};
+        }
+    }
+}
+
+inline auto Pagemap::find(const void* ptr) noexcept -> Entry* {
+    const uintptr_t key = uintptr_t(ptr) >> SHIFT;
+    if((key >> LEAF) >= (uintptr_t(1) << ROOT)) {
+        return nullptr; // out of range
+    }
+
+    Leaf* leaf = root[key >> LEAF].load(std::memory_order_acquire);
+    if(!leaf) {
+        return nullptr;
+    }
+
+    Entry* entry = &leaf->entries[key & ((uintptr_t(1) << LEAF) - 1)];
+    return entry->cls ? entry : nullptr;
+}
+
+inline bool Pagemap::release(void* ptr) noexcept {
+    Entry* entry = find(ptr);
+    if(!entry) {
+        return false; // not registered
+    }
+    entry->cls->release(entry->owner, ptr);
+    return true;
+}
+
+inline size_t Pagemap::size(const void* ptr) noexcept {
+    Entry* entry = find(ptr);
+    if(!entry) {
+        return 0;
+    }
+    return entry->cls->block ? entry->cls->block : find(entry->base)->slot; // variable: stored at base
+}
+
+inline bool Pagemap::check(const void* ptr) noexcept {
+    Entry* entry = find(ptr);
+    return entry && entry->cls->check(entry->owner, ptr);
+}
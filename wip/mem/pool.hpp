@@ -1,14 +1,218 @@
+#ifndef MEM_POOL_HPP
+#define MEM_POOL_HPP
+
 #include "allocator.hpp"
 
-//! @brief object pool
-template<typename T, size_t ALIGNMENT = sizeof(T)>
-class Pool : public Allocator<global::bit_align(sizeof(T), ALIGNMENT)> {
+/**
+ * @brief object pool, ALIGNMENT is raised to alignof(T) at least
+ *
+ * @tparam GEN generation bits of Handle, 0 ~ 8, 0 is without stale handle check
+ * @tparam P   policy traits of Allocator
+ *
+ * [handle]
+ * 32-bit: [ generation: GEN | chunk id | block index: Base::SLOT ], 0 is null
+ */
+template<typename T, size_t ALIGNMENT = alignof(T), size_t GEN = 0, typename P = Policy>
+class Pool : public Allocator<global::bit_align(sizeof(T), ALIGNMENT > alignof(T) ? ALIGNMENT : alignof(T)), P> {
+public:
+    static constexpr size_t BLOCK = global::bit_align(sizeof(T), ALIGNMENT > alignof(T) ? ALIGNMENT : alignof(T));
+    using Base = Allocator<BLOCK, P>;
+
+    //! @brief alignment check, every block is aligned to Base::ALIGN
+    static_assert(global::bit_aligned(ALIGNMENT) && Base::ALIGN >= ALIGNMENT && Base::ALIGN >= alignof(T));
+
 public:
-    static constexpr size_t BLOCK = global::bit_align(sizeof(T), ALIGNMENT); // same as parent
-    using Base = Allocator<BLOCK>;
+    using Handle = uint32_t; //!< compact reference, 0 is null
+
+private:
+    //! @brief T has on_relocate(T* from)
+    template<typename U, typename = void> struct Relocatable : std::false_type { };
+    template<typename U>
+    struct Relocatable<U, std::void_t<decltype(std::declval<U&>().on_relocate(std::declval<U*>()))>> : std::true_type { };
+
+private:
+    static constexpr uint32_t LOC = GEN ? uint32_t((uint64_t(1) << (32 - GEN)) - 1) : ~uint32_t(0); //!< location mask
+
+    //! @brief handle fits in 32 bits, WHOLE has no slot, checked by handle calls only
+    static constexpr bool HANDLE = Base::SLOT != 0 && Base::SLOT + GEN < 32;
+
+    //! @brief generation check
+    static_assert(GEN <= 8);
+
+public:
+    using Base::Base;
+    using Base::release;
+    using Base::release_deferred;
+
+public:
+    //! @brief free, GEN: handles of object are stale
+    void release(T* ptr) {
+        expire(ptr);
+        Base::release(ptr);
+    }
+
+public:
+    //! @brief batch free, GEN: handles of objects are stale
+    void release(T* const* ptrs, size_t cnt) {
+        for(size_t i = 0; i < cnt; ++i) {
+            expire(ptrs[i]);
+        }
+        Base::release(ptrs, cnt);
+    }
+
+public:
+    //! @brief free later, GEN: handles of object are stale now
+    void release_deferred(T* ptr) {
+        expire(ptr);
+        Base::release_deferred(ptr);
+    }
 
 public:
     template<typename... Args> T* acquire(Args&&... in) {
         return Base::template acquire<T>(std::forward<Args>(in)...);
     }
+
+public:
+    template<typename... Args> T* acquire_aligned(size_t align, Args&&... in) {
+        return Base::template acquire_aligned<T>(align, std::forward<Args>(in)...);
+    }
+
+public:
+    //! @brief in the chunk of hint, nearest free block to it
+    template<typename... Args> T* acquire_near(const T* hint, Args&&... in) {
+        return Base::template acquire_near<T>(hint, std::forward<Args>(in)...);
+    }
+
+public:
+    //! @brief visit live objects in address order, fn(T*)
+    template<typename Fn> void for_each_live(Fn&& fn) {
+        Base::template for_each_live<T>(std::forward<Fn>(fn));
+    }
+
+public:
+    /**
+     * @brief incremental compaction, fn(T* from, T* to) moves object and updates its references
+     * @note  handles of moved objects are stale, handle(to) is the new one
+     * @return moved objects count
+     */
+    template<typename Fn> size_t compact(size_t budget, Fn&& fn) {
+        return Base::template compact<T>(budget, std::forward<Fn>(fn));
+    }
+
+public:
+    /**
+     * @brief incremental compaction by move constructor, then to->on_relocate(from) if T has it
+     * @note  handles of moved objects are stale, handle(to) is the new one
+     * @return moved objects count
+     */
+    size_t compact(size_t budget) {
+        return Base::template compact<T>(budget, [](T* from, T* to) {
+            new(to) T(std::move(*from));
+            from->~T();
+            if constexpr(Relocatable<T>::value) {
+                to->on_relocate(from);
+            }
+        });
+    }
+
+public:
+    //! @brief call destructors of live objects, then reset
+    void destroy_all() {
+        Base::template destroy_all<T>();
+    }
+
+public:
+    /**
+     * @brief acquire as handle, any release advances generation
+     * @return 0 if failed, or chunk id out of handle bits
+     */
+    template<typename... Args> Handle acquire_handle(Args&&... in) {
+        static_assert(HANDLE); // WHOLE, or out of bits
+
+        T* ptr = acquire(std::forward<Args>(in)...);
+        if(!ptr) {
+            return 0; // failed
+        }
+
+        const Handle out = handle(ptr);
+        if(out == 0) {
+            Base::release(ptr);
+            return 0; // not registered, or out of bits
+        }
+        return out;
+    }
+
+public:
+    /**
+     * @brief handle of live object, e.g. new handle of moved object in compact
+     * @return 0 if not registered, out of bits or failed
+     */
+    Handle handle(const T* ptr) noexcept {
+        static_assert(HANDLE); // WHOLE, or out of bits
+
+        const uint32_t loc = Base::locate(ptr);
+        if(loc == 0 || loc > LOC) {
+            return 0; // not registered, or out of bits
+        }
+
+        if constexpr(GEN != 0) {
+            const uint8_t* gen = Base::generation(loc, true);
+            if(!gen) {
+                return 0; // failed
+            }
+            return (Handle(*gen & ((1u << GEN) - 1)) << (32 - GEN)) | loc;
+        }
+        else return loc;
+    }
+
+public:
+    /**
+     * @brief O(1), handle to object
+     * @return nullptr if chunk destroyed, or stale generation
+     */
+    T* resolve(Handle in) const noexcept {
+        static_assert(HANDLE); // WHOLE, or out of bits
+
+        const uint32_t loc = in & LOC;
+        if constexpr(GEN != 0) {
+            const uint8_t* gen = Base::generation(loc);
+            if(!gen || (*gen & ((1u << GEN) - 1)) != (in >> (32 - GEN))) {
+                return nullptr; // stale
+            }
+        }
+        return static_cast<T*>(Base::place(loc));
+    }
+
+public:
+    /**
+     * @brief release by handle, crash if stale
+     */
+    void release(Handle in) {
+        static_assert(HANDLE); // WHOLE, or out of bits
+
+        T* ptr = resolve(in);
+        if(!ptr) {
+            std::abort(); // stale or double free
+        }
+        if constexpr(GEN != 0) {
+            ++*Base::generation(in & LOC); // invalidate handles
+        }
+        Base::release(ptr);
+    }
+
+private:
+    //! @brief GEN: advance generation of block if it has counters
+    static void expire(const T* ptr) noexcept {
+        if constexpr(GEN != 0 && HANDLE) {
+            const uint32_t loc = Base::locate(ptr);
+            if(loc != 0) {
+                uint8_t* gen = Base::generation(loc);
+                if(gen) {
+                    ++*gen; // invalidate handles
+                }
+            }
+        }
+    }
 };
+
+#endif
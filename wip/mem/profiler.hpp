@@ -0,0 +1,125 @@
+#ifndef MEM_PROFILER_HPP
+#define MEM_PROFILER_HPP
+
+#include "../core/spin.hpp"
+#include "../global/pal.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+
+/**
+ * @brief sampling heap profiler, a sample per about rate bytes acquired (Poisson), with allocation stack
+ * @note  not sampling costs a thread local decrement and a branch in acquire,
+ *        release looks up only chunks having samples
+ *
+ * [usage]
+ * Profiler::start(512 * 1024);
+ * ...
+ * Profiler::dump(stdout, Profiler::Format::FOLDED); // flamegraph.pl input, live bytes
+ */
+class Profiler {
+public:
+    static constexpr size_t DEPTH   = 32;      //!< max frames per stack
+    static constexpr size_t STACKS  = 1 << 12; //!< max distinct stacks
+    static constexpr size_t SAMPLES = 1 << 18; //!< max live samples
+
+public:
+    //! @brief dump format
+    enum class Format : uint8_t {
+        PPROF,  //!< legacy heap profile text, readable by pprof
+        FOLDED, //!< folded stacks of live bytes, frame;frame;frame bytes
+    };
+
+public:
+    /**
+     * @brief start sampling
+     *
+     * @param [in] rate mean bytes between samples
+     */
+    static void start(size_t rate = 512 * 1024) noexcept;
+
+public:
+    /**
+     * @brief stop sampling, live samples are kept until released
+     */
+    static void stop() noexcept;
+
+public:
+    /**
+     * @brief hot path of acquire, count down bytes of calling thread
+     * @return true if sample is due
+     */
+    static bool tick(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief slow path of acquire, capture stack and record, or reset count down if stopped
+     * @return true if recorded
+     */
+    static bool sample(const void* ptr, size_t byte) noexcept;
+
+public:
+    /**
+     * @brief release of block in chunk having samples
+     */
+    static void forget(const void* ptr) noexcept;
+
+public:
+    /**
+     * @brief block moved by compaction, sample of from is kept as to
+     */
+    static void move(const void* from, const void* to) noexcept;
+
+public:
+    /**
+     * @brief live sample count
+     */
+    static size_t live() noexcept;
+
+public:
+    /**
+     * @brief write profile
+     * @return false if failed
+     */
+    static bool dump(FILE* out, Format format = Format::PPROF) noexcept;
+
+public:
+    /**
+     * @brief drop all samples and stacks
+     */
+    static void clear() noexcept;
+
+private:
+    struct Stack;  //!< allocation site
+    struct Sample; //!< live sampled block
+
+private:
+    //! @brief exponential interval of mean rate
+    static intptr_t interval() noexcept;
+
+private:
+    //! @brief reserve tables, call with lock
+    static bool prepare() noexcept;
+
+private:
+    //! @brief slot of sampled block, SAMPLES if not sampled, call with lock
+    static size_t find(const void* ptr) noexcept;
+
+private:
+    //! @brief backward shift deletion, keep probe chains without tombstone, call with lock
+    static void erase(size_t slot) noexcept;
+
+private:
+    static inline thread_local intptr_t countdown = 0; //!< bytes until next sample
+
+private:
+    static inline std::atomic<size_t> rate{ 0 };  //!< 0 is stopped
+    static inline std::atomic<size_t> count{ 0 }; //!< live samples
+    static inline core::Spin          lock;
+    static inline Stack*              stacks  = nullptr;
+    static inline Sample*             samples = nullptr;
+};
+
+#include "profiler.ipp"
+#endif
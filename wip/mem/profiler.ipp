@@ -0,0 +1,290 @@
+#ifndef MEM_PROFILER_HPP
+#    include "profiler.hpp"
+#endif
+
+#if CHECK_TARGET(OS_POSIX) && __has_include(<dlfcn.h>)
+#    include <dlfcn.h>
+#endif
+
+struct Profiler::Stack {
+    uint64_t hash;  //!< 0 is empty slot
+    size_t   depth;
+    void*    frame[DEPTH];
+    double   alloc_cnt;  //!< estimated, sampled / probability
+    double   alloc_byte; //!< estimated
+    double   live_cnt;   //!< estimated
+    double   live_byte;  //!< estimated
+};
+
+struct Profiler::Sample {
+    const void* ptr; //!< nullptr is empty slot
+    uint32_t    stack;
+    uint32_t    byte;
+    double      scale; //!< 1 / probability
+};
+
+inline void Profiler::start(size_t in) noexcept {
+    {
+        std::lock_guard<core::Spin> guard(lock);
+        if(!prepare()) {
+            return; // failed
+        }
+    }
+    rate.store(in ? in : 1, std::memory_order_relaxed);
+}
+
+inline void Profiler::stop() noexcept {
+    rate.store(0, std::memory_order_relaxed);
+}
+
+inline bool Profiler::tick(size_t byte) noexcept {
+    return (countdown -= intptr_t(byte)) < 0;
+}
+
+inline bool Profiler::sample(const void* ptr, size_t byte) noexcept {
+    const size_t mean = rate.load(std::memory_order_relaxed);
+    if(mean == 0) {
+        countdown = 512 * 1024; // stopped: check again later
+        return false;
+    }
+    countdown = interval();
+
+    void*  frame[DEPTH];
+    size_t depth = global::pal_stack(frame, DEPTH, 1); // skip this
+
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for(size_t i = 0; i < depth; ++i) {
+        hash = (hash ^ uint64_t(uintptr_t(frame[i]))) * 0x100000001B3ull;
+    }
+    hash |= 1; // 0 is empty
+
+    // probability of this size to be sampled
+    const double scale = 1.0 / (1.0 - std::exp(-double(byte) / double(mean)));
+
+    std::lock_guard<core::Spin> guard(lock);
+
+    // find or insert stack
+    size_t index = size_t(hash) & (STACKS - 1);
+    for(size_t i = 0; i < STACKS; ++i, index = (index + 1) & (STACKS - 1)) {
+        Stack& curr = stacks[index];
+        if(curr.hash == hash && curr.depth == depth && std::memcmp(curr.frame, frame, depth * sizeof(void*)) == 0) {
+            break; // found
+        }
+        if(curr.hash == 0) {
+            curr.hash  = hash;
+            curr.depth = depth;
+            std::memcpy(curr.frame, frame, depth * sizeof(void*));
+            break; // new
+        }
+    }
+    Stack& stack = stacks[index];
+    if(stack.hash != hash) {
+        return false; // full
+    }
+
+    // insert sample, load factor up to 3/4
+    if(count.load(std::memory_order_relaxed) >= SAMPLES / 4 * 3) {
+        return false; // full
+    }
+    size_t slot = (uintptr_t(ptr) >> 4) & (SAMPLES - 1);
+    while(samples[slot].ptr) {
+        slot = (slot + 1) & (SAMPLES - 1);
+    }
+    samples[slot] = { ptr, uint32_t(index), uint32_t(byte), scale };
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    stack.alloc_cnt  += scale;
+    stack.alloc_byte += scale * double(byte);
+    stack.live_cnt   += scale;
+    stack.live_byte  += scale * double(byte);
+    return true;
+}
+
+inline void Profiler::forget(const void* ptr) noexcept {
+    if(count.load(std::memory_order_relaxed) == 0) {
+        return; // none
+    }
+
+    std::lock_guard<core::Spin> guard(lock);
+
+    const size_t slot = find(ptr);
+    if(slot == SAMPLES) {
+        return; // not sampled
+    }
+
+    Sample& out   = samples[slot];
+    Stack&  stack = stacks[out.stack];
+    stack.live_cnt  -= out.scale;
+    stack.live_byte -= out.scale * double(out.byte);
+    count.fetch_sub(1, std::memory_order_relaxed);
+    erase(slot);
+}
+
+inline void Profiler::move(const void* from, const void* to) noexcept {
+    if(count.load(std::memory_order_relaxed) == 0) {
+        return; // none
+    }
+
+    std::lock_guard<core::Spin> guard(lock);
+
+    const size_t slot = find(from);
+    if(slot == SAMPLES) {
+        return; // not sampled
+    }
+
+    Sample moved = samples[slot];
+    erase(slot);
+
+    // reinsert at home of to, count is unchanged
+    size_t next = (uintptr_t(to) >> 4) & (SAMPLES - 1);
+    while(samples[next].ptr) {
+        next = (next + 1) & (SAMPLES - 1);
+    }
+    moved.ptr     = to;
+    samples[next] = moved;
+}
+
+inline size_t Profiler::find(const void* ptr) noexcept {
+    size_t slot = (uintptr_t(ptr) >> 4) & (SAMPLES - 1);
+    while(samples[slot].ptr != ptr) {
+        if(!samples[slot].ptr) {
+            return SAMPLES; // not sampled
+        }
+        slot = (slot + 1) & (SAMPLES - 1);
+    }
+    return slot;
+}
+
+inline void Profiler::erase(size_t slot) noexcept {
+    size_t hole = slot;
+    size_t next = (hole + 1) & (SAMPLES - 1);
+    while(samples[next].ptr) {
+        const size_t home = (uintptr_t(samples[next].ptr) >> 4) & (SAMPLES - 1);
+        // move if home is not in (hole, next]
+        if(((next - home) & (SAMPLES - 1)) >= ((next - hole) & (SAMPLES - 1))) {
+            samples[hole] = samples[next];
+            hole          = next;
+        }
+        next = (next + 1) & (SAMPLES - 1);
+    }
+    samples[hole].ptr = nullptr;
+}
+
+inline size_t Profiler::live() noexcept {
+    return count.load(std::memory_order_relaxed);
+}
+
+inline bool Profiler::dump(FILE* out, Format format) noexcept {
+    if(!out) {
+        return false;
+    }
+
+    std::lock_guard<core::Spin> guard(lock);
+    if(!stacks) {
+        return false; // never started
+    }
+
+    if(format == Format::PPROF) {
+        double live_cnt = 0, live_byte = 0, alloc_cnt = 0, alloc_byte = 0;
+        for(size_t i = 0; i < STACKS; ++i) {
+            live_cnt   += stacks[i].live_cnt;
+            live_byte  += stacks[i].live_byte;
+            alloc_cnt  += stacks[i].alloc_cnt;
+            alloc_byte += stacks[i].alloc_byte;
+        }
+
+        // figures are unsampled already, no rate: pprof must not scale them again
+        std::fprintf(out, "heap profile: %.0f: %.0f [%.0f: %.0f] @ heap\n", live_cnt, live_byte, alloc_cnt, alloc_byte);
+
+        for(size_t i = 0; i < STACKS; ++i) {
+            const Stack& curr = stacks[i];
+            if(curr.hash == 0) continue;
+
+            std::fprintf(out, "%.0f: %.0f [%.0f: %.0f] @", curr.live_cnt, curr.live_byte, curr.alloc_cnt, curr.alloc_byte);
+            for(size_t j = 0; j < curr.depth; ++j) {
+                std::fprintf(out, " %p", curr.frame[j]);
+            }
+            std::fputc('\n', out);
+        }
+
+#if CHECK_TARGET(OS_POSIX)
+        // for symbolization
+        std::fputs("\nMAPPED_LIBRARIES:\n", out);
+        FILE* maps = std::fopen("/proc/self/maps", "r");
+        if(maps) {
+            char   buf[4096];
+            size_t len;
+            while((len = std::fread(buf, 1, sizeof(buf), maps)) > 0) {
+                std::fwrite(buf, 1, len, out);
+            }
+            std::fclose(maps);
+        }
+#endif
+    }
+    else {
+        for(size_t i = 0; i < STACKS; ++i) {
+            const Stack& curr = stacks[i];
+            if(curr.hash == 0 || curr.live_byte < 0.5) continue;
+
+            // outermost first
+            for(size_t j = curr.depth; j-- > 0;) {
+                const char* name = nullptr;
+#if CHECK_TARGET(OS_POSIX) && __has_include(<dlfcn.h>)
+                Dl_info info;
+                if(dladdr(curr.frame[j], &info) && info.dli_sname) {
+                    name = info.dli_sname;
+                }
+#endif
+                if(name) {
+                    std::fputs(name, out);
+                }
+                else std::fprintf(out, "%p", curr.frame[j]);
+
+                if(j) std::fputc(';', out);
+            }
+            std::fprintf(out, " %.0f\n", curr.live_byte);
+        }
+    }
+    return std::ferror(out) == 0;
+}
+
+inline void Profiler::clear() noexcept {
+    std::lock_guard<core::Spin> guard(lock);
+    if(stacks) {
+        std::memset(static_cast<void*>(stacks), 0, STACKS * sizeof(Stack));
+        std::memset(static_cast<void*>(samples), 0, SAMPLES * sizeof(Sample));
+    }
+    count.store(0, std::memory_order_relaxed);
+}
+
+inline intptr_t Profiler::interval() noexcept {
+    static thread_local uint64_t seed = uint64_t(uintptr_t(&seed)) | 1; // per thread
+
+    // xorshift64
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+
+    const double uniform = double((seed >> 11) + 1) / double(uint64_t(1) << 53); // (0, 1]
+    const double next    = -std::log(uniform) * double(rate.load(std::memory_order_relaxed));
+    return next < 1.0 ? 1 : (next > 1e15 ? intptr_t(1e15) : intptr_t(next));
+}
+
+inline bool Profiler::prepare() noexcept {
+    if(stacks) {
+        return true; // reserved
+    }
+
+    // committed on touch
+    stacks  = global::pal_valloc<Stack>(STACKS * sizeof(Stack));
+    samples = global::pal_valloc<Sample>(SAMPLES * sizeof(Sample));
+    if(!stacks || !samples) {
+        global::pal_vfree(stacks, STACKS * sizeof(Stack));
+        global::pal_vfree(samples, SAMPLES * sizeof(Sample));
+        stacks  = nullptr;
+        samples = nullptr;
+        return false;
+    }
+    return true;
+}
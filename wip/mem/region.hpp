@@ -0,0 +1,82 @@
+#ifndef MEM_REGION_HPP
+#define MEM_REGION_HPP
+
+#include "../core/spin.hpp"
+#include "../global/bit.hpp"
+#include "../global/num.hpp"
+#include "backend.hpp"
+#include <mutex>
+
+/**
+ * @brief fixed capacity backend carving chunks from caller memory, e.g. static storage or region premapped at startup
+ * @note  thread safe, freed ranges are reused by size in O(1) for power of 2 sizes,
+ *        alignment gap is not reused, so align base to chunk size for no waste
+ *
+ * [memory layout]
+ * +-------+-------+-----+--------+
+ * | chunk | chunk | ... | remain |
+ * +-------+-------+-----+--------+
+ * ^ base                ^ cursor
+ */
+class Region : public Backend {
+public:
+    /**
+     * @param [in] base region begin, not owned
+     * @param [in] byte region size
+     */
+    Region(void* base, size_t byte) noexcept;
+
+public:
+    Region(const Region&)            = delete;
+    Region& operator=(const Region&) = delete;
+
+public:
+    /**
+     * @brief carve a range, freed range of same size is reused first
+     *
+     * @param [in] byte  range size
+     * @param [in] align address alignment, power of 2
+     * @return nullptr if out of space
+     */
+    void* map(size_t byte, size_t align) noexcept;
+
+public:
+    /**
+     * @brief return a range
+     *
+     * @param [in] ptr  pointer from map
+     * @param [in] byte same size used when calling map
+     */
+    void unmap(void* ptr, size_t byte) noexcept;
+
+public:
+    /**
+     * @brief get remained carvable bytes, freed ranges are not counted
+     */
+    size_t remain() const noexcept;
+
+public:
+    /**
+     * @brief check range is in region
+     */
+    bool contains(const void* ptr) const noexcept;
+
+private:
+    //! @brief freed range header, single linked list per log2 size
+    struct Free {
+        Free*  next;
+        size_t byte;
+    };
+
+private:
+    uint8_t*   base;   //!< region begin
+    size_t     byte;   //!< region size
+    size_t     cursor; //!< carve position from base
+    core::Spin lock;   //!< map and unmap lock
+
+private:
+    Free* frees[64] = {}; //!< freed ranges by floor log2 size
+};
+
+#include "region.ipp"
+#endif
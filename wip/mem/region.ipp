@@ -0,0 +1,53 @@
+#ifndef MEM_REGION_HPP
+#    include "region.hpp"
+#endif
+
+inline Region::Region(void* base, size_t byte) noexcept: base(static_cast<uint8_t*>(base)), byte(base ? byte : 0), cursor(0) {
+    generate = [](Backend* self, size_t byte, size_t align) noexcept { return static_cast<Region*>(self)->map(byte, align); };
+    destroy  = [](Backend* self, void* ptr, size_t byte) noexcept { static_cast<Region*>(self)->unmap(ptr, byte); };
+}
+
+inline void* Region::map(size_t byte, size_t align) noexcept {
+    if(byte == 0 || !global::bit_aligned(align)) {
+        return nullptr; // invalid
+    }
+    std::lock_guard<core::Spin> guard(lock);
+
+    // first: reuse freed range of same size
+    for(Free** link = &frees[63 - global::bit_clz(byte)]; *link; link = &(*link)->next) {
+        Free* free = *link;
+        if(free->byte == byte && global::bit_aligned(uintptr_t(free), align)) {
+            *link = free->next; // unlink
+            return free;
+        }
+    }
+
+    // second: carve
+    const uintptr_t at    = uintptr_t(base) + cursor;
+    const size_t    begin = cursor + (global::num_align(at, align) - at);
+    if(begin > this->byte || byte > this->byte - begin) {
+        return nullptr; // out of space
+    }
+    cursor = begin + byte;
+
+    return base + begin;
+}
+
+inline void Region::unmap(void* ptr, size_t byte) noexcept {
+    if(!ptr) return;
+    std::lock_guard<core::Spin> guard(lock);
+
+    Free*  free = new(ptr) Free;
+    Free*& head = frees[63 - global::bit_clz(byte)];
+    free->byte  = byte;
+    free->next  = head; // push front
+    head        = free;
+}
+
+inline size_t Region::remain() const noexcept {
+    return byte - cursor;
+}
+
+inline bool Region::contains(const void* ptr) const noexcept {
+    return static_cast<const uint8_t*>(ptr) >= base && static_cast<const uint8_t*>(ptr) < base + byte;
+}
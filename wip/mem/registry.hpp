@@ -0,0 +1,132 @@
+#ifndef MEM_REGISTRY_HPP
+#define MEM_REGISTRY_HPP
+
+#include "../core/spin.hpp"
+#include "../global/pal.hpp"
+#include "cache.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief process wide list of live allocators, and memory pressure driven shrink
+ * @note  allocators are not thread safe, so shrink runs on the thread owning the allocator:
+ *        reclaim() by calling thread directly, watch() thread only raises pressure,
+ *        and the first allocator of a thread reaching a slow path, release into an idle chunk or chunk syscall,
+ *        runs reclaim() for the whole thread, maintain() shrinks its own allocator,
+ *        allocators of a thread reaching none of them keep their chunks, call reclaim() on it periodically
+ */
+class Registry {
+public:
+    //! @brief object queued by release_deferred, allocated by std::malloc
+    struct Deferred {
+        Deferred* next;
+        void*     ptr;
+        void      (*dtor)(void* ptr); //!< destructor, nullptr is trivial
+        void      (*free)(void* ptr); //!< thread safe release as remote free
+    };
+
+public:
+    //! @brief allocator record, embedded in allocator
+    struct Entry {
+        void*           owner;                     //!< allocator
+        size_t          (*idle)(const void* owner); //!< bytes of unused chunks
+        size_t          (*shrink)(void* owner, size_t cnt); //!< destroy up to cnt unused chunks, return count
+        Deferred*       (*take)(void* owner);      //!< pop all deferred objects, thread safe, nullptr if not supported
+        size_t          chunk;                     //!< chunk size
+        std::thread::id thread;                    //!< constructed on
+        Entry*          next;
+        Entry*          prev;
+    };
+
+public:
+    /**
+     * @brief register, called by allocator constructor
+     */
+    static void insert(Entry* in) noexcept;
+
+public:
+    /**
+     * @brief unregister, called by allocator destructor
+     */
+    static void erase(Entry* in) noexcept;
+
+public:
+    /**
+     * @brief trim Cache, then shrink allocators of calling thread, biggest idle footprint first, one chunk at a time
+     *
+     * @param [in] byte bytes to release, 0 is all unused chunks
+     * @return released bytes
+     */
+    static size_t reclaim(size_t byte = 0) noexcept;
+
+public:
+    /**
+     * @brief bytes of unused chunks of allocators of calling thread
+     */
+    static size_t idle() noexcept;
+
+public:
+    /**
+     * @brief pressure generation, allocators compare to the last seen value
+     */
+    static uint32_t pressure() noexcept;
+
+public:
+    /**
+     * @brief raise pressure, every allocator shrinks at its next chance
+     */
+    static void signal() noexcept;
+
+public:
+    /**
+     * @brief start watcher thread, raise pressure and trim Cache while global::pal_pressure is over threshold
+     *
+     * @param [in] threshold percent of global::pal_pressure, e.g. 10 is PSI some avg10 10%, or 82% usage of limit
+     * @param [in] period    poll period in milliseconds
+     * @return false if already watching, or pressure is not supported
+     */
+    static bool watch(int threshold = 10, uint32_t period = 1000) noexcept;
+
+public:
+    /**
+     * @brief stop watcher thread
+     */
+    static void unwatch() noexcept;
+
+public:
+    /**
+     * @brief run destructors of deferred objects of all allocators, then release as remote free, any thread
+     * @note  destructors run on calling thread, memory they release must go through allocators of calling thread,
+     *        e.g. Malloc::local()
+     *
+     * @return reclaimed object count
+     */
+    static size_t reap() noexcept;
+
+public:
+    /**
+     * @brief start reclaimer thread, reap every period
+     *
+     * @param [in] period poll period in milliseconds
+     * @return false if already running
+     */
+    static bool reaper(uint32_t period = 1) noexcept;
+
+public:
+    /**
+     * @brief stop reclaimer thread
+     */
+    static void unreap() noexcept;
+
+private:
+    static inline core::Spin            lock;          //!< list lock
+    static inline Entry*                head = nullptr; //!< live allocators
+    static inline std::atomic<uint32_t> level{ 0 };    //!< pressure generation
+    static inline std::atomic<bool>     running{ false };
+    static inline std::atomic<bool>     reaping{ false };
+};
+
+#include "registry.ipp"
+#endif
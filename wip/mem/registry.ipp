@@ -0,0 +1,174 @@
+#ifndef MEM_REGISTRY_HPP
+#    include "registry.hpp"
+#endif
+
+inline void Registry::insert(Entry* in) noexcept {
+    in->thread = std::this_thread::get_id();
+    in->prev   = nullptr;
+
+    std::lock_guard<core::Spin> guard(lock);
+    in->next = head;
+    if(head) {
+        head->prev = in;
+    }
+    head = in;
+}
+
+inline void Registry::erase(Entry* in) noexcept {
+    std::lock_guard<core::Spin> guard(lock);
+    if(in->prev) in->prev->next = in->next;
+    if(in->next) in->next->prev = in->prev;
+    if(in == head) head = in->next;
+}
+
+inline size_t Registry::reclaim(size_t byte) noexcept {
+    const std::thread::id self = std::this_thread::get_id();
+
+    size_t out = Cache::trim(byte); // first: cached chunks of any thread
+    size_t cut = 0;                 // shrunk chunks may be cached
+    while(byte == 0 || out + cut < byte) {
+        Entry* pick = nullptr;
+        size_t most = 0;
+
+        // biggest idle footprint of this thread
+        {
+            std::lock_guard<core::Spin> guard(lock);
+            for(Entry* curr = head; curr; curr = curr->next) {
+                if(curr->thread != self) continue;
+
+                const size_t idle = curr->idle(curr->owner);
+                if(idle > most) {
+                    most = idle;
+                    pick = curr;
+                }
+            }
+        }
+        if(!pick) {
+            break; // nothing to release
+        }
+
+        // entry of this thread is erased only by this thread
+        const size_t cnt = pick->shrink(pick->owner, byte ? 1 : ~size_t(0));
+        if(cnt == 0) {
+            break; // unreachable, idle but not shrinkable
+        }
+        cut += cnt * pick->chunk;
+    }
+    if(cut) {
+        Cache::trim(byte ? cut : 0);
+    }
+    return out + cut;
+}
+
+inline size_t Registry::idle() noexcept {
+    const std::thread::id self = std::this_thread::get_id();
+
+    std::lock_guard<core::Spin> guard(lock);
+
+    size_t out = 0;
+    for(Entry* curr = head; curr; curr = curr->next) {
+        if(curr->thread == self) {
+            out += curr->idle(curr->owner);
+        }
+    }
+    return out;
+}
+
+inline uint32_t Registry::pressure() noexcept {
+    return level.load(std::memory_order_relaxed);
+}
+
+inline void Registry::signal() noexcept {
+    level.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline bool Registry::watch(int threshold, uint32_t period) noexcept {
+    if(global::pal_pressure() < 0) {
+        return false; // not supported
+    }
+
+    bool expect = false;
+    if(!running.compare_exchange_strong(expect, true)) {
+        return false; // already
+    }
+
+    try {
+        std::thread([threshold, period]() {
+            while(running.load(std::memory_order_relaxed)) {
+                if(global::pal_pressure() >= threshold) {
+                    signal();
+                    Cache::trim(); // chunks shrunk since last poll
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(period));
+            }
+        }).detach();
+    }
+    catch(...) {
+        running = false;
+        return false; // thread creation failed
+    }
+    return true;
+}
+
+inline void Registry::unwatch() noexcept {
+    running.store(false, std::memory_order_relaxed);
+}
+
+inline size_t Registry::reap() noexcept {
+    // gather under lock: allocators are not destroyed while taking
+    Deferred* batch = nullptr;
+    {
+        std::lock_guard<core::Spin> guard(lock);
+        for(Entry* curr = head; curr; curr = curr->next) {
+            if(!curr->take) continue;
+
+            Deferred* list = curr->take(curr->owner);
+            while(list) {
+                Deferred* next = list->next;
+                list->next     = batch;
+                batch          = list;
+                list           = next;
+            }
+        }
+    }
+
+    // run out of lock, destructors may destroy allocators
+    size_t out = 0;
+    while(batch) {
+        Deferred* next = batch->next;
+        if(batch->dtor) {
+            batch->dtor(batch->ptr);
+        }
+        batch->free(batch->ptr);
+        std::free(batch);
+        batch = next;
+        ++out;
+    }
+    return out;
+}
+
+inline bool Registry::reaper(uint32_t period) noexcept {
+    bool expect = false;
+    if(!reaping.compare_exchange_strong(expect, true)) {
+        return false; // already
+    }
+
+    try {
+        std::thread([period]() {
+            while(reaping.load(std::memory_order_relaxed)) {
+                if(reap() == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(period)); // idle
+                }
+            }
+        }).detach();
+    }
+    catch(...) {
+        reaping = false;
+        return false; // thread creation failed
+    }
+    return true;
+}
+
+inline void Registry::unreap() noexcept {
+    reaping.store(false, std::memory_order_relaxed);
+}
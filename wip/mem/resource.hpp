@@ -0,0 +1,53 @@
+#ifndef MEM_RESOURCE_HPP
+#define MEM_RESOURCE_HPP
+
+#include "malloc.hpp"
+#include <memory_resource>
+#include <new>
+
+/**
+ * @brief std::pmr resource by size class of Malloc::local(), stateless, every instance is equal
+ * @note  alignment over PAL_BOUNDARY is served by aligned operator new
+ */
+class Resource : public std::pmr::memory_resource {
+public:
+    //! @brief shared instance
+    static Resource* get() noexcept {
+        static Resource instance;
+        return &instance;
+    }
+
+private:
+    //! @brief size rounded up to alignment lands on a size class aligned by it
+    static size_t fit(size_t byte, size_t align) noexcept {
+        return byte > align ? global::num_align(byte, align) : align;
+    }
+
+private:
+    void* do_allocate(size_t byte, size_t align) override {
+        if(align > global::PAL_BOUNDARY) {
+            return ::operator new(byte, std::align_val_t(align));
+        }
+
+        void* out = Malloc::local().acquire(fit(byte, align));
+        if(!out) {
+            throw std::bad_alloc();
+        }
+        return out;
+    }
+
+private:
+    void do_deallocate(void* ptr, size_t byte, size_t align) override {
+        if(align > global::PAL_BOUNDARY) {
+            ::operator delete(ptr, byte, std::align_val_t(align));
+        }
+        else Malloc::local().release(ptr, fit(byte, align));
+    }
+
+private:
+    bool do_is_equal(const std::pmr::memory_resource& in) const noexcept override {
+        return dynamic_cast<const Resource*>(&in) != nullptr;
+    }
+};
+
+#endif
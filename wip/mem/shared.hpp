@@ -0,0 +1,76 @@
+#ifndef MEM_SHARED_HPP
+#define MEM_SHARED_HPP
+
+#include "allocator.hpp"
+#include "../core/spin.hpp"
+
+/**
+ * @brief cross-process allocator, construct in shared heap by Heap::root
+ * @note  bitmap and chunk lists are updated under the address free lock,
+ *        objects must not hold process local pointers (vtable, private memory), use core::Offset for links
+ *
+ * [usage]
+ * Heap*       heap  = Heap::share("/queue", 1 << 30);
+ * Shared<64>* alloc = heap->root<Shared<64>>(0, heap);
+ * uint64_t    msg   = heap->offset(alloc->acquire()); // producer: send offset only
+ * alloc->release(heap->resolve(msg));                 // consumer
+ */
+template<size_t N> class Shared {
+public:
+    using Base = Allocator<N>;
+
+public:
+    /**
+     * @param [in] heap shared heap, this must be in the heap
+     */
+    explicit Shared(Heap* heap): base(heap) { }
+
+public:
+    template<typename T = void, typename... Args> T* acquire(Args&&... in) noexcept {
+        std::lock_guard<core::Spin> guard(lock);
+        return base.template acquire<T>(std::forward<Args>(in)...);
+    }
+
+public:
+    template<typename T = void> void release(T* in) {
+        std::lock_guard<core::Spin> guard(lock);
+        base.release(in);
+    }
+
+public:
+    //! @brief batch, locked once
+    template<typename T = void> void release(T* const* in, size_t cnt) {
+        std::lock_guard<core::Spin> guard(lock);
+        base.release(in, cnt);
+    }
+
+public:
+    size_t reserve(size_t cnt) {
+        std::lock_guard<core::Spin> guard(lock);
+        return base.reserve(cnt);
+    }
+
+public:
+    size_t shrink() {
+        std::lock_guard<core::Spin> guard(lock);
+        return base.shrink();
+    }
+
+public:
+    size_t maintain(size_t low, size_t high) {
+        std::lock_guard<core::Spin> guard(lock);
+        return base.maintain(low, high);
+    }
+
+public:
+    size_t usable() {
+        std::lock_guard<core::Spin> guard(lock);
+        return base.usable();
+    }
+
+private:
+    Base       base; //!< chunks in heap
+    core::Spin lock; //!< process shared lock
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef MEM_SIZECLASS_HPP
+#define MEM_SIZECLASS_HPP
+
+#include "../global/bit.hpp"
+
+/**
+ * @brief size class table
+ *
+ * 16 ~ 128     : 16 bytes step            (8 classes)
+ * 129 ~ 256KiB : 4 classes per power of 2 (44 classes)
+ */
+class SizeClass {
+public:
+    static constexpr size_t COUNT = 52;      //!< class count
+    static constexpr size_t LARGE = 1 << 18; //!< 256 KiB: max block
+
+public:
+    /**
+     * @param [in] index class index
+     * @return block size of class
+     */
+    static constexpr size_t block(size_t index) noexcept;
+
+public:
+    /**
+     * @param [in] byte request size, up to LARGE
+     * @return class index
+     */
+    static constexpr size_t index(size_t byte) noexcept;
+};
+
+#include "sizeclass.ipp"
+#endif
@@ -0,0 +1,20 @@
+#ifndef MEM_SIZECLASS_HPP
+#    include "sizeclass.hpp"
+#endif
+
+constexpr size_t SizeClass::block(size_t index) noexcept {
+    if(index < 8) {
+        return (index + 1) << 4; // 16 bytes step
+    }
+    const size_t step = index - 8;
+    const size_t base = size_t(1) << (7 + step / 4); // power of 2
+    return base + (step % 4 + 1) * (base >> 2);      // 4 classes per power of 2
+}
+
+constexpr size_t SizeClass::index(size_t byte) noexcept {
+    if(byte <= 128) {
+        return byte ? (byte - 1) >> 4 : 0;
+    }
+    const size_t log = size_t(63 - global::bit_clz(byte - 1));  // floor(log2(byte - 1))
+    return 8 + (log - 7) * 4 + (((byte - 1) >> (log - 2)) & 3); // base class + quarter
+}
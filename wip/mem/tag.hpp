@@ -0,0 +1,79 @@
+#ifndef MEM_TAG_HPP
+#define MEM_TAG_HPP
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief tenant byte budget, over budget acquire fails fast with nullptr before any slow path
+ * @note  charged by usable size where blocks are taken and returned:
+ *        Allocator or Pool bound by bind() charges BLOCK in acquire and refunds in release, as meta.used changes,
+ *        Malloc charges size class block or large mapping by acquire(byte, tag), refunds by release(ptr, tag),
+ *        callable from any thread
+ *
+ * [usage]
+ * Tag tenant(64 << 20);
+ * pool.bind(&tenant);
+ * Node* node = pool.acquire(...);                    // nullptr if over budget
+ * void* ptr  = Malloc::local().acquire(100, tenant); // nullptr if over budget
+ * Malloc::local().release(ptr, tenant);
+ */
+class Tag {
+public:
+    /**
+     * @param [in] budget OPTIONAL: max charged bytes, unlimited if omitted
+     */
+    explicit Tag(size_t budget = ~size_t(0)) noexcept;
+
+public:
+    /**
+     * @brief O(1): reserve bytes
+     *
+     * @return false if over budget, nothing is reserved then
+     */
+    bool charge(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief reserve bytes over budget, e.g. live blocks of adopted chunk
+     */
+    void debit(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief return reserved bytes
+     */
+    void refund(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief change budget, already charged bytes are kept
+     */
+    void budget(size_t byte) noexcept;
+
+public:
+    /**
+     * @brief max charged bytes
+     */
+    size_t budget() const noexcept;
+
+public:
+    /**
+     * @brief charged bytes
+     */
+    size_t used() const noexcept;
+
+public:
+    /**
+     * @brief acquire count failed by budget
+     */
+    size_t rejected() const noexcept;
+
+private:
+    std::atomic<size_t> limit;          //!< budget
+    std::atomic<size_t> bytes{ 0 };     //!< charged
+    std::atomic<size_t> misses{ 0 };    //!< rejected acquire
+};
+
+#include "tag.ipp"
+#endif
@@ -0,0 +1,40 @@
+#ifndef MEM_TAG_HPP
+#    include "tag.hpp"
+#endif
+
+inline Tag::Tag(size_t budget) noexcept: limit(budget) { }
+
+inline bool Tag::charge(size_t byte) noexcept {
+    // optimistic add, undo on overrun: no CAS loop
+    const size_t now = bytes.fetch_add(byte, std::memory_order_relaxed) + byte;
+    if(now > limit.load(std::memory_order_relaxed) || now < byte) {
+        bytes.fetch_sub(byte, std::memory_order_relaxed);
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+inline void Tag::debit(size_t byte) noexcept {
+    bytes.fetch_add(byte, std::memory_order_relaxed);
+}
+
+inline void Tag::refund(size_t byte) noexcept {
+    bytes.fetch_sub(byte, std::memory_order_relaxed);
+}
+
+inline void Tag::budget(size_t byte) noexcept {
+    limit.store(byte, std::memory_order_relaxed);
+}
+
+inline size_t Tag::budget() const noexcept {
+    return limit.load(std::memory_order_relaxed);
+}
+
+inline size_t Tag::used() const noexcept {
+    return bytes.load(std::memory_order_relaxed);
+}
+
+inline size_t Tag::rejected() const noexcept {
+    return misses.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,99 @@
+#include "../mem/malloc.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+int main() {
+    Malloc& heap = Malloc::local();
+
+    // owner exits with live blocks, its chunks are abandoned
+    std::vector<void*> live;
+    std::thread([&] {
+        for(int i = 0; i < 5000; ++i) {
+            void* ptr = Malloc::local().acquire(48);
+            std::memset(ptr, 0xAB, 48);
+            live.push_back(ptr);
+        }
+    }).join();
+
+    // remote frees to abandoned chunks
+    for(size_t i = 0; i < live.size(); i += 2) {
+        heap.release(live[i]);
+    }
+
+    // new thread adopts them before generating
+    std::vector<void*> got;
+    std::thread([&] {
+        for(int i = 0; i < 2500; ++i) {
+            got.push_back(Malloc::local().acquire(48));
+        }
+        for(void* ptr : got) {
+            Malloc::local().release(ptr);
+        }
+    }).join();
+    std::vector<void*> freed;
+    for(size_t i = 0; i < live.size(); i += 2) {
+        freed.push_back(live[i]);
+    }
+    std::sort(freed.begin(), freed.end());
+    size_t reused = 0;
+    for(void* ptr : got) {
+        reused += std::binary_search(freed.begin(), freed.end(), ptr) ? 1 : 0;
+    }
+    CHECK(reused > 0);
+
+    // blocks still live in adopted chunks are intact
+    for(size_t i = 1; i < live.size(); i += 2) {
+        CHECK(static_cast<unsigned char*>(live[i])[47] == 0xAB);
+        heap.release(live[i]);
+    }
+
+    // size-free release from other thread races destruction of owner
+    for(int round = 0; round < 20; ++round) {
+        std::vector<void*> blocks(20000);
+        std::atomic<bool>  go{ false };
+        std::thread owner([&] {
+            Allocator<64>* alloc = new Allocator<64>;
+            for(void*& ptr : blocks) {
+                ptr = alloc->acquire();
+            }
+            go.store(true, std::memory_order_release);
+            delete alloc; // chunks with live blocks are abandoned
+        });
+        while(!go.load(std::memory_order_acquire)) { }
+        for(void* ptr : blocks) {
+            heap.release(ptr); // remote free, owner may be gone
+        }
+        owner.join();
+    }
+
+    // producer and consumer threads with live owner
+    std::atomic<void*> slot[1024] = {};
+    std::thread producer([&] {
+        for(int i = 0; i < 200000; ++i) {
+            void* ptr = Malloc::local().acquire(64);
+            void* none = nullptr;
+            while(!slot[i % 1024].compare_exchange_weak(none, ptr)) {
+                none = nullptr;
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::thread consumer([&] {
+        for(int done = 0; done < 200000;) {
+            for(std::atomic<void*>& next : slot) {
+                void* ptr = next.exchange(nullptr);
+                if(ptr) {
+                    Malloc::local().release(ptr);
+                    ++done;
+                }
+            }
+        }
+    });
+    producer.join();
+    consumer.join();
+    return 0;
+}
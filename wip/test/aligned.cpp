@@ -0,0 +1,53 @@
+#include "../mem/malloc.hpp"
+#include "../mem/pool.hpp"
+#include "check.hpp"
+
+struct alignas(64) Line {
+    char data[64];
+};
+
+struct alignas(32) Vec {
+    float lane[8];
+    Vec(float in) { lane[0] = in; }
+};
+
+int main() {
+    // natural alignment of block, and over-aligned slow path
+    Allocator<96> odd;
+    CHECK(Allocator<96>::ALIGN == 32);
+    void* plain = odd.acquire_aligned(16);
+    CHECK(plain && uintptr_t(plain) % 16 == 0);
+    Line* line = odd.acquire_aligned<Line>(64);
+    CHECK(line && uintptr_t(line) % 64 == 0);
+    void* wide = odd.acquire_aligned(128);
+    CHECK(wide && uintptr_t(wide) % 128 == 0);
+    Line* raised = odd.acquire_aligned<Line>(8); // type alignment at least
+    CHECK(raised && uintptr_t(raised) % alignof(Line) == 0);
+    CHECK(!odd.acquire_aligned(48));                        // not power of 2
+    CHECK(!odd.acquire_aligned(global::PAL_PAGE << 1));     // over page
+    odd.release(plain);
+    odd.release(line);
+    odd.release(wide);
+    odd.release(raised);
+
+    // compile time, pool blocks follow the type
+    Pool<Vec> pool;
+    for(int i = 0; i < 1000; ++i) {
+        Vec* vec = pool.acquire(float(i));
+        CHECK(vec && uintptr_t(vec) % alignof(Vec) == 0 && vec->lane[0] == float(i));
+        pool.release(vec);
+    }
+    Pool<char, 64> padded;
+    char* c = padded.acquire();
+    CHECK(c && uintptr_t(c) % 64 == 0);
+    padded.release(c);
+
+    // every alignment up to page, size-free release
+    Allocator<24> small;
+    for(size_t align = 8; align <= global::PAL_PAGE; align <<= 1) {
+        void* ptr = small.acquire_aligned(align);
+        CHECK(ptr && uintptr_t(ptr) % align == 0);
+        Malloc::local().release(ptr);
+    }
+    return 0;
+}
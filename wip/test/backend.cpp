@@ -0,0 +1,89 @@
+#include "../mem/pool.hpp"
+#include "../mem/region.hpp"
+#include "check.hpp"
+#include <vector>
+
+alignas(65536) static uint8_t memory[4 << 20];
+alignas(65536) static uint8_t large[8 << 20];
+
+struct Obj {
+    long a[5];
+};
+
+//! @brief counting backend over Region
+struct Counted : Backend {
+    Region region;
+    size_t generated = 0;
+    size_t destroyed = 0;
+
+    Counted(void* base, size_t byte): Backend{ &map, &unmap }, region(base, byte) { }
+
+    static void* map(Backend* self, size_t byte, size_t align) noexcept {
+        Counted* counted = static_cast<Counted*>(self);
+        ++counted->generated;
+        return counted->region.map(byte, align);
+    }
+
+    static void unmap(Backend* self, void* ptr, size_t byte) noexcept {
+        Counted* counted = static_cast<Counted*>(self);
+        ++counted->destroyed;
+        counted->region.unmap(ptr, byte);
+    }
+};
+
+int main() {
+    // fixed capacity: nullptr when exhausted, every block inside
+    Region             region(memory, sizeof(memory));
+    Allocator<64>      alloc(&region);
+    std::vector<void*> blocks;
+    while(void* ptr = alloc.acquire()) {
+        CHECK(region.contains(ptr));
+        blocks.push_back(ptr);
+    }
+    CHECK(blocks.size() >= (sizeof(memory) / Allocator<64>::CHUNK - 1) * Allocator<64>::UNIT);
+    CHECK(region.remain() < Allocator<64>::CHUNK);
+
+    // shared by other allocator, freed chunks are reused
+    Pool<Obj> pool(&region);
+    CHECK(!pool.acquire());
+    for(void* ptr : blocks) {
+        alloc.release(ptr);
+    }
+    CHECK(alloc.shrink() > 0);
+    std::vector<Obj*> objs;
+    while(Obj* obj = pool.acquire()) {
+        CHECK(region.contains(obj) && pool.check(obj));
+        objs.push_back(obj);
+    }
+    CHECK(!objs.empty());
+    for(Obj* obj : objs) {
+        pool.release(obj);
+    }
+
+    // WHOLE
+    Region                     huge(large, sizeof(large));
+    Allocator<size_t(2) << 20> whole(&huge);
+    void*                      first  = whole.acquire();
+    void*                      second = whole.acquire();
+    CHECK(first && huge.contains(first) && second && huge.contains(second));
+    whole.release(first);
+    whole.release(second);
+
+    // custom backend gets every chunk, and every chunk back
+    alignas(65536) static uint8_t counted_memory[2 << 20];
+    Counted counted(counted_memory, sizeof(counted_memory));
+    {
+        Allocator<128>     mine(&counted);
+        std::vector<void*> used;
+        for(int i = 0; i < 5000; ++i) {
+            used.push_back(mine.acquire());
+            CHECK(counted.region.contains(used.back()));
+        }
+        CHECK(counted.generated > 0);
+        for(void* ptr : used) {
+            mine.release(ptr);
+        }
+    }
+    CHECK(counted.destroyed == counted.generated);
+    return 0;
+}
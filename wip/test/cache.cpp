@@ -0,0 +1,78 @@
+#include "../mem/allocator.hpp"
+#include "check.hpp"
+#include <thread>
+#include <vector>
+
+struct Direct : Policy {
+    static constexpr Backing BACKING = Backing::DIRECT;
+};
+
+int main() {
+    Cache::trim();
+    CHECK(Cache::size() == 0);
+
+    // chunks shrunk by one size class are cached
+    std::vector<void*> blocks;
+    size_t             shrunk;
+    {
+        Allocator<24> first;
+        for(int i = 0; i < 100000; ++i) {
+            blocks.push_back(first.acquire());
+        }
+        for(void* ptr : blocks) {
+            first.release(ptr);
+        }
+        blocks.clear();
+        shrunk = first.shrink();
+        CHECK(shrunk > 0 && Cache::size() == shrunk * Allocator<24>::CHUNK);
+    }
+
+    // and taken by another size class of the same chunk size, on another thread
+    static_assert(Allocator<32>::CHUNK == Allocator<24>::CHUNK);
+    const size_t cached = Cache::size();
+    std::thread([&] {
+        Allocator<32> second;
+        for(int i = 0; i < 50000; ++i) {
+            void* ptr = second.acquire();
+            CHECK(second.check(ptr));
+            blocks.push_back(ptr);
+        }
+        CHECK(Cache::size() < cached);
+        for(void* ptr : blocks) {
+            second.release(ptr);
+        }
+        blocks.clear();
+        second.shrink();
+    }).join();
+    CHECK(Cache::size() == cached);
+
+    // DIRECT backing bypasses the cache
+    {
+        Allocator<24, Direct> direct;
+        direct.release(direct.acquire());
+        CHECK(Cache::size() == cached);
+        direct.shrink();
+        CHECK(Cache::size() == cached);
+    }
+
+    // limit trims surplus, and caps later gives
+    Cache::limit(Allocator<24>::CHUNK);
+    CHECK(Cache::size() <= Allocator<24>::CHUNK);
+    {
+        Allocator<24> third;
+        for(int i = 0; i < 100000; ++i) {
+            blocks.push_back(third.acquire());
+        }
+        for(void* ptr : blocks) {
+            third.release(ptr);
+        }
+        blocks.clear();
+        third.shrink();
+        CHECK(Cache::size() <= Allocator<24>::CHUNK);
+    }
+
+    // registry reclaim trims
+    CHECK(Registry::reclaim() > 0 || Cache::size() == 0);
+    CHECK(Cache::size() == 0);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @brief test assertion kept in release build, prints location and exits with failure
+ *
+ * [usage]
+ * // one test per file, e.g. g++ -std=c++17 -pthread aligned.cpp && ./a.out
+ * int main() {
+ *     CHECK(ptr != nullptr);
+ * }
+ */
+#define CHECK(expr)                                                                       \
+    do {                                                                                  \
+        if(!(expr)) {                                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+            std::exit(EXIT_FAILURE);                                                      \
+        }                                                                                 \
+    } while(0)
+
+#endif
@@ -0,0 +1,84 @@
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <cstring>
+#include <vector>
+
+struct Entry;
+static std::vector<Entry*> table;
+
+struct Entry {
+    long   id;
+    size_t slot;
+    Entry(long in, size_t at): id(in), slot(at) { }
+    void on_relocate(Entry*) { table[slot] = this; } // fix the only reference
+};
+
+struct Stats : Policy {
+    static constexpr bool STATS = true;
+};
+
+int main() {
+    // by move constructor and on_relocate, in budget steps
+    {
+        Pool<Entry> pool;
+        for(long i = 0; i < 50000; ++i) {
+            table.push_back(pool.acquire(i, size_t(i)));
+        }
+        for(size_t i = 0; i < table.size(); ++i) {
+            if(i % 10) {
+                pool.release(table[i]);
+                table[i] = nullptr;
+            }
+        }
+        const size_t before = pool.usable();
+        size_t       moved  = 0, step;
+        while((step = pool.compact(500))) {
+            CHECK(step <= 500);
+            moved += step;
+        }
+        CHECK(moved > 0);
+
+        size_t live = 0;
+        for(size_t i = 0; i < table.size(); ++i) {
+            if(table[i]) {
+                CHECK(table[i]->id == long(i) && pool.check(table[i]));
+                ++live;
+            }
+        }
+        size_t visit = 0;
+        pool.for_each_live([&](Entry*) { ++visit; });
+        CHECK(live == 5000 && visit == live);
+
+        pool.shrink();
+        CHECK(pool.usable() < before); // emptied chunks destroyed
+        for(Entry* entry : table) {
+            if(entry) pool.release(entry);
+        }
+    }
+
+    // by callback, sampled blocks keep their samples
+    {
+        Profiler::start(1024);
+        Allocator<64, Stats> alloc;
+        std::vector<void*>   blocks;
+        for(int i = 0; i < 20000; ++i) {
+            blocks.push_back(alloc.acquire());
+        }
+        for(size_t i = 0; i < blocks.size(); ++i) {
+            if(i % 16) alloc.release(blocks[i]);
+        }
+        const size_t sampled = Profiler::live();
+        CHECK(sampled > 0);
+        CHECK(alloc.compact(~size_t(0), [](void* from, void* to) { std::memcpy(to, from, 64); }) > 0);
+        CHECK(Profiler::live() == sampled);
+
+        std::vector<void*> moved;
+        alloc.for_each_live([&](void* ptr) { moved.push_back(ptr); });
+        for(void* ptr : moved) {
+            alloc.release(ptr); // forgotten at new address
+        }
+        CHECK(Profiler::live() == 0);
+        Profiler::stop();
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct Shared : Policy {
+    static constexpr Thread THREAD = Thread::SHARED;
+};
+
+struct Node {
+    uint64_t a;
+
+    Node(uint64_t in): a(in) { }
+};
+
+//! @brief fill block with a pattern of its address
+template<size_t N> static void fill(void* ptr) {
+    uint64_t* word = static_cast<uint64_t*>(ptr);
+    for(size_t i = 0; i < N / 8; ++i) {
+        word[i] = uint64_t(uintptr_t(ptr)) ^ i;
+    }
+}
+
+//! @brief pattern is intact, no block handed out twice
+template<size_t N> static bool valid(void* ptr) {
+    const uint64_t* word = static_cast<const uint64_t*>(ptr);
+    for(size_t i = 0; i < N / 8; ++i) {
+        if(word[i] != (uint64_t(uintptr_t(ptr)) ^ i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<size_t N> static void check(int threads, int loops) {
+    Allocator<N, Shared>            alloc;
+    std::vector<std::atomic<void*>> slots(4096); // cross-thread handoff
+    std::vector<std::thread>        workers;
+    std::atomic<int>                corrupt{ 0 };
+    for(std::atomic<void*>& slot : slots) {
+        slot.store(nullptr);
+    }
+    for(int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<void*> mine;
+            uint64_t           seed = uint64_t(t) * 7919 + 1;
+            for(int i = 0; i < loops; ++i) {
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                const int op = int((seed >> 33) % 4);
+                if(op < 2 || mine.empty()) {
+                    void* ptr = alloc.acquire();
+                    CHECK(ptr);
+                    fill<N>(ptr);
+                    mine.push_back(ptr);
+                    continue;
+                }
+                void* ptr = mine.back();
+                mine.pop_back();
+                corrupt += !valid<N>(ptr);
+                if(op == 2) {
+                    // released by another thread
+                    ptr = slots[(seed >> 20) % slots.size()].exchange(ptr);
+                    if(!ptr) continue;
+                    corrupt += !valid<N>(ptr);
+                }
+                alloc.release(ptr);
+            }
+            for(void* ptr : mine) {
+                alloc.release(ptr);
+            }
+        });
+    }
+    for(std::thread& worker : workers) {
+        worker.join();
+    }
+    for(std::atomic<void*>& slot : slots) {
+        if(void* ptr = slot.load()) {
+            alloc.release(ptr);
+        }
+    }
+    CHECK(corrupt == 0);
+
+    size_t live = 0;
+    alloc.for_each_live([&](void*) { ++live; });
+    CHECK(live == 0);
+    constexpr size_t unit = Allocator<N, Shared>::UNIT;
+    alloc.shrink();
+    CHECK(alloc.usable() <= unit); // current chunk is kept
+}
+
+int main() {
+    check<16>(8, 50000);
+    check<64>(8, 50000);
+    check<200>(4, 50000);
+    check<1024>(8, 20000);
+
+    // pool: near falls back to acquire, aligned over ALIGN unsupported
+    Pool<Node, alignof(Node), 0, Shared> pool;
+    Node*                                first  = pool.acquire(5);
+    Node*                                second = pool.acquire_near(first, 6);
+    CHECK(first->a == 5 && second->a == 6);
+    CHECK(!pool.acquire_aligned(256, 1));
+    pool.release(first);
+    pool.release(second);
+    return 0;
+}
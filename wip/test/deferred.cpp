@@ -0,0 +1,68 @@
+#include "../mem/malloc.hpp"
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<int> destroyed{ 0 };
+
+//! @brief destructor releasing memory of its own
+struct Heavy {
+    void* inner;
+
+    Heavy(): inner(Malloc::local().acquire(1000)) { }
+
+    ~Heavy() {
+        Malloc::local().release(inner);
+        ++destroyed;
+    }
+};
+
+int main() {
+    // owner drain, bounded then all
+    Pool<Heavy> pool;
+    for(int i = 0; i < 1000; ++i) {
+        pool.release_deferred(pool.acquire());
+    }
+    CHECK(destroyed == 0);
+    CHECK(pool.drain_deferred(300) == 300 && destroyed == 300);
+    CHECK(pool.drain_deferred() == 700 && destroyed == 1000);
+    CHECK(pool.drain_deferred() == 0);
+
+    // reap on another thread releases as remote free
+    for(int i = 0; i < 1000; ++i) {
+        pool.release_deferred(pool.acquire());
+    }
+    size_t reaped = 0;
+    std::thread([&] { reaped = Registry::reap(); }).join();
+    CHECK(reaped >= 1000 && destroyed == 2000);
+
+    // reclaimer thread
+    CHECK(Registry::reaper(1));
+    CHECK(!Registry::reaper(1));
+    for(int i = 0; i < 20000; ++i) {
+        pool.release_deferred(pool.acquire());
+    }
+    for(int i = 0; i < 5000 && destroyed < 22000; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    Registry::unreap();
+    pool.drain_deferred();
+    CHECK(destroyed == 22000);
+
+    // destructor drains
+    {
+        Pool<Heavy> scoped;
+        for(int i = 0; i < 10; ++i) {
+            scoped.release_deferred(scoped.acquire());
+        }
+    }
+    CHECK(destroyed == 22010);
+
+    // nothing left behind
+    size_t live = 0;
+    pool.for_each_live([&](void*) { ++live; });
+    CHECK(live == 0);
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "../mem/epoch.hpp"
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <thread>
+#include <vector>
+
+struct Concurrent : Policy {
+    static constexpr Thread THREAD = Thread::SHARED;
+};
+
+static int dead = 0;
+
+struct Node {
+    std::atomic<Node*> next{ nullptr };
+    long               value;
+    Node(long in): value(in) { }
+    ~Node() { ++dead; }
+};
+
+int main() {
+    // lock-free stack, popped nodes retired under pin
+    {
+        Epoch              domain;
+        std::atomic<Node*> top{ nullptr };
+        std::atomic<long>  popped{ 0 };
+
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                Epoch::Local* local = domain.join();
+                CHECK(local);
+                for(int i = 0; i < 100000; ++i) {
+                    if((i + t) % 2 == 0) {
+                        Node* node = new(Malloc::local().acquire(sizeof(Node))) Node(i);
+                        Node* head = top.load();
+                        do {
+                            node->next.store(head);
+                        } while(!top.compare_exchange_weak(head, node));
+                    }
+                    else {
+                        Epoch::Guard guard = local->pin();
+                        Node*        head  = top.load();
+                        while(head && !top.compare_exchange_weak(head, head->next.load())) { }
+                        if(head) {
+                            CHECK(head->value >= 0); // not released while pinned
+                            local->retire(head);
+                            ++popped;
+                        }
+                    }
+                }
+                domain.leave(local);
+            });
+        }
+        for(std::thread& thread : threads) {
+            thread.join();
+        }
+        CHECK(popped > 0);
+        domain.collect();
+        CHECK(domain.epoch() > 2);
+
+        Node* head = top.load();
+        while(head) {
+            Node* next = head->next;
+            Malloc::local().release(head);
+            head = next;
+        }
+    }
+
+    // retired blocks outlive pin for 2 epochs
+    {
+        Allocator<64> alloc;
+        Tag           live;
+        alloc.bind(&live);
+
+        Epoch         domain(alloc);
+        Epoch::Local* local = domain.join();
+        {
+            Epoch::Guard guard = local->pin();
+            local->retire(alloc.acquire());
+            CHECK(local->flush() == 0); // pinned
+        }
+        local->flush();
+        local->flush();
+        CHECK(local->flush() == 0 && live.used() == 0); // released to owner by batch
+        domain.leave(local);
+    }
+
+    // typed sink: destructors run and handles expire
+    {
+        using Objs = Pool<Node, alignof(Node), 4>;
+        Objs         pool;
+        Objs::Handle handle;
+        {
+            Epoch         domain(Epoch::batch<Node, Objs>, &pool);
+            Epoch::Local* local = domain.join();
+            Node*         node  = pool.acquire(1);
+            handle              = pool.acquire_handle(2);
+            local->retire(node);
+            local->retire(pool.resolve(handle));
+            domain.leave(local);
+        }
+        CHECK(dead == 2 && !pool.resolve(handle));
+    }
+
+    // SHARED owner from many threads
+    {
+        Allocator<64, Concurrent> alloc;
+        Tag                       live;
+        alloc.bind(&live);
+        {
+            Epoch                    domain(alloc);
+            std::vector<std::thread> threads;
+            for(int t = 0; t < 4; ++t) {
+                threads.emplace_back([&] {
+                    Epoch::Local* local = domain.join();
+                    for(int i = 0; i < 20000; ++i) {
+                        Epoch::Guard guard = local->pin();
+                        local->retire(alloc.acquire());
+                    }
+                    domain.leave(local);
+                });
+            }
+            for(std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+        CHECK(live.used() == 0);
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "../mem/frame.hpp"
+#include "check.hpp"
+#include <thread>
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+#    include <coroutine>
+
+//! @brief lazy generator of ints, frame by Frame
+struct Counter {
+    struct promise_type : Frame {
+        int value = 0;
+
+        Counter             get_return_object() { return Counter{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(int in) noexcept {
+            value = in;
+            return {};
+        }
+        void                return_void() noexcept { }
+        void                unhandled_exception() { std::abort(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+static Counter count(int limit) {
+    for(int i = 0; i < limit; ++i) {
+        co_yield i;
+    }
+}
+#endif
+
+int main() {
+    // operators route to size classes
+    void* frame = Frame::operator new(200);
+    CHECK(frame && Pagemap::size(frame) >= 200 && Pagemap::size(frame) <= SizeClass::LARGE);
+    const uintptr_t address = uintptr_t(frame);
+    Frame::operator delete(frame, 200);
+    CHECK(!Pagemap::check(reinterpret_cast<void*>(address)));
+
+    void* quiet = Frame::operator new(300, std::nothrow);
+    CHECK(quiet);
+    Frame::operator delete(quiet, 300);
+
+    // frame released on other thread is a remote free
+    void* moved = Frame::operator new(64);
+    std::thread([moved] { Frame::operator delete(moved, 64); }).join();
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+    for(int round = 0; round < 1000; ++round) {
+        Counter counter = count(10);
+        CHECK(Pagemap::check(counter.handle.address())); // not elided, escapes to caller
+        int sum = 0;
+        while(true) {
+            counter.handle.resume();
+            if(counter.handle.done()) break;
+            sum += counter.handle.promise().value;
+        }
+        CHECK(sum == 45);
+        counter.handle.destroy();
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <vector>
+
+struct Obj {
+    int    a;
+    double b;
+    Obj(int in): a(in), b(in * 2.0) { }
+};
+
+using Gen   = Pool<Obj, alignof(Obj), 8>;
+using Plain = Pool<Obj>;
+
+int main() {
+    static_assert(sizeof(Gen::Handle) == 4);
+
+    Gen                      pool;
+    std::vector<Gen::Handle> handles;
+    for(int i = 0; i < 100000; ++i) {
+        const Gen::Handle handle = pool.acquire_handle(i);
+        CHECK(handle);
+        handles.push_back(handle);
+    }
+    for(int i = 0; i < 100000; ++i) {
+        Obj* obj = pool.resolve(handles[i]);
+        CHECK(obj && obj->a == i && pool.handle(obj) == handles[i]);
+    }
+    CHECK(!pool.resolve(0));
+
+    // every release makes handles stale, and the reused block gets a new one
+    const Gen::Handle by_handle = handles[5];
+    pool.release(by_handle);
+    CHECK(!pool.resolve(by_handle));
+    const Gen::Handle next = pool.acquire_handle(7);
+    CHECK(next != by_handle && pool.resolve(next)->a == 7);
+
+    const Gen::Handle by_ptr = handles[6];
+    pool.release(pool.resolve(by_ptr));
+    CHECK(!pool.resolve(by_ptr));
+
+    Obj* batch[2] = { pool.resolve(handles[7]), pool.resolve(handles[8]) };
+    pool.release(batch, 2);
+    CHECK(!pool.resolve(handles[7]) && !pool.resolve(handles[8]));
+
+    pool.release_deferred(pool.resolve(handles[9]));
+    CHECK(!pool.resolve(handles[9]));
+    pool.drain_deferred();
+
+    // compaction: moved objects have new handles
+    for(size_t i = 10; i < handles.size(); ++i) {
+        if(i % 16) {
+            pool.release(handles[i]);
+        }
+    }
+    pool.compact(~size_t(0));
+    size_t stale = 0;
+    for(size_t i = 16; i < handles.size(); i += 16) {
+        Obj* obj = pool.resolve(handles[i]);
+        if(!obj) {
+            ++stale; // moved
+        }
+        else CHECK(obj->a == int(i));
+    }
+    CHECK(stale > 0);
+    pool.for_each_live([&](Obj* obj) {
+        const Gen::Handle handle = pool.handle(obj);
+        CHECK(handle && pool.resolve(handle) == obj);
+    });
+    pool.destroy_all();
+
+    // without generation, handle is location only
+    Plain               plain;
+    const Plain::Handle handle = plain.acquire_handle(3);
+    CHECK(handle && plain.resolve(handle)->a == 3);
+    plain.release(handle);
+    return 0;
+}
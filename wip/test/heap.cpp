@@ -0,0 +1,89 @@
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct Node {
+    int                v;
+    core::Offset<Node> next;
+    Node(int in): v(in) { }
+};
+
+struct Root {
+    core::Offset<Node> head;
+};
+
+int main() {
+    const std::string path = "/tmp/heap_test_" + std::to_string(getpid()) + ".bin";
+    std::remove(path.c_str());
+
+    // build
+    void* old = nullptr;
+    {
+        Heap* heap = Heap::open(path.c_str(), 64 << 20);
+        CHECK(heap);
+        Pool<Node>* pool = heap->root<Pool<Node>>(0, heap);
+        Root*       root = heap->root<Root>(1);
+        CHECK(pool && root);
+        for(int i = 0; i < 100000; ++i) {
+            Node* node = pool->acquire(i);
+            CHECK(node);
+            node->next = root->head.get();
+            root->head = node;
+        }
+        for(int i = 0; i < 10; ++i) { // 99999 ~ 99990
+            Node* node = root->head;
+            root->head = node->next.get();
+            pool->release(node);
+        }
+        CHECK(!heap->root<Node>(1, 0)); // size differs from stored root
+        old = heap;
+        Heap::close(heap);
+    }
+
+    // restore at other base
+    void* block = mmap(old, 1 << 24, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    {
+        Heap* heap = Heap::open(path.c_str(), 0);
+        CHECK(heap);
+        Pool<Node>* pool = heap->root<Pool<Node>>(0, heap);
+        Root*       root = heap->root<Root>(1);
+
+        long long sum = 0, cnt = 0;
+        for(Node* node = root->head; node; node = node->next) {
+            sum += node->v;
+            ++cnt;
+        }
+        CHECK(cnt == 99990 && sum == 99990LL * 99989 / 2);
+
+        // freed blocks are reused, offsets stay valid in the new mapping
+        const size_t remain = heap->remain();
+        for(int i = 0; i < 10; ++i) {
+            Node* node = pool->acquire(-1);
+            CHECK(heap->resolve<Node>(heap->offset(node)) == node);
+            pool->release(node);
+        }
+        CHECK(heap->remain() == remain);
+
+        while(root->head) {
+            Node* node = root->head;
+            root->head = node->next.get();
+            pool->release(node);
+        }
+        CHECK(pool->shrink() > 0);
+        Heap::close(heap);
+    }
+    munmap(block, 1 << 24);
+
+    // not a heap
+    {
+        FILE* file = std::fopen(path.c_str(), "r+b");
+        CHECK(file);
+        std::fputs("garbage!", file);
+        std::fclose(file);
+        CHECK(!Heap::open(path.c_str(), 0));
+    }
+    std::remove(path.c_str());
+    return 0;
+}
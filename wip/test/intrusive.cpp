@@ -0,0 +1,111 @@
+#include "../mem/allocator.hpp"
+#include "check.hpp"
+#include <csignal>
+#include <cstring>
+#include <random>
+#include <set>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// per size class, specialized before use
+template<> struct Tracking<64> {
+    static constexpr Track MODE   = Track::LIST;
+    static constexpr bool  HARDEN = true;
+};
+
+struct List : Policy {
+    static constexpr Track TRACK = Track::LIST;
+};
+
+template<typename A, size_t S> void run() {
+    A                  alloc;
+    std::set<void*>    live;
+    std::vector<void*> blocks;
+    std::mt19937       random(1);
+
+    // random mix, checked against a model
+    for(int step = 0; step < 200000; ++step) {
+        const unsigned op = random() % 10;
+        if(op < 5 || blocks.empty()) {
+            void* ptr = op == 0 ? alloc.acquire_aligned(256) : alloc.acquire();
+            CHECK(ptr && live.insert(ptr).second);
+            CHECK(op != 0 || uintptr_t(ptr) % 256 == 0);
+            blocks.push_back(ptr);
+        }
+        else {
+            const size_t index = random() % blocks.size();
+            void*        ptr   = blocks[index];
+            blocks[index]      = blocks.back();
+            blocks.pop_back();
+            live.erase(ptr);
+            alloc.release(ptr);
+        }
+        if(step % 20000 == 0) {
+            size_t cnt = 0;
+            alloc.for_each_live([&](void* ptr) {
+                CHECK(live.count(ptr));
+                ++cnt;
+            });
+            CHECK(cnt == live.size());
+            for(void* ptr : blocks) {
+                CHECK(alloc.check(ptr));
+            }
+        }
+    }
+
+    // remote frees to abandoned chunks, adopted and drained
+    std::vector<void*> foreign;
+    std::thread([&] {
+        A other;
+        for(int i = 0; i < 5000; ++i) {
+            foreign.push_back(other.acquire());
+        }
+    }).join();
+    for(void* ptr : foreign) {
+        alloc.release(ptr);
+    }
+    for(int i = 0; i < 3000; ++i) {
+        void* ptr = alloc.acquire();
+        CHECK(live.insert(ptr).second);
+    }
+
+    // compaction keeps the list consistent
+    alloc.compact(~size_t(0), [](void* from, void* to) { std::memcpy(to, from, S); });
+    size_t cnt = 0;
+    alloc.for_each_live([&](void*) { ++cnt; });
+    CHECK(cnt == live.size());
+
+    alloc.reset();
+    cnt = 0;
+    alloc.for_each_live([&](void*) { ++cnt; });
+    CHECK(cnt == 0);
+    for(int i = 0; i < 1000; ++i) {
+        CHECK(alloc.acquire());
+    }
+}
+
+int main() {
+    run<Allocator<64>, 64>();        // LIST by Tracking, HARDEN
+    run<Allocator<136, List>, 136>(); // LIST by Policy
+    run<Allocator<72>, 72>();         // BITMAP
+
+    // HARDEN: corrupted link of free block aborts on pop
+    const pid_t pid = fork();
+    CHECK(pid >= 0);
+    if(pid == 0) {
+        Allocator<64> alloc;
+        void*         first  = alloc.acquire();
+        void*         second = alloc.acquire();
+        alloc.release(second);
+        alloc.release(first);
+        std::memset(first, 0x41, 16); // write after free
+        alloc.acquire();
+        alloc.acquire();
+        _exit(0);
+    }
+    int status = 0;
+    CHECK(waitpid(pid, &status, 0) == pid && WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+    return 0;
+}
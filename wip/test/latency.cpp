@@ -0,0 +1,72 @@
+#define MEM_LATENCY 1 // sample every call
+
+#include "../mem/allocator.hpp"
+#include "check.hpp"
+#include <thread>
+#include <vector>
+
+using Alloc = Allocator<64>;
+
+// bucket bounds
+static_assert(Latency::bucket(0) == 0 && Latency::bucket(7) == 7);
+static_assert(Latency::bucket(Latency::bound(100)) == 100 && Latency::bucket(Latency::bound(100) + 1) == 101);
+static_assert(Latency::bucket(~uint64_t(0)) == Latency::BUCKET - 1);
+
+int main() {
+    for(uint64_t tick = 0; tick < (1u << 20); ++tick) {
+        const size_t index = Latency::bucket(tick);
+        CHECK(Latency::bound(index) >= tick);
+        CHECK(index == 0 || Latency::bound(index - 1) < tick);
+        CHECK(Latency::bound(index) - (index ? Latency::bound(index - 1) : 0) <= tick / 8 + 1); // error under 12.5%
+    }
+
+    // percentiles
+    Latency manual;
+    for(uint64_t tick = 1; tick <= 1000; ++tick) {
+        manual.record(Latency::Op::ACQUIRE, Latency::Path::FAST, tick);
+    }
+    const Latency::Report report = manual.report(Latency::Op::ACQUIRE, Latency::Path::FAST);
+    CHECK(report.count == 1000);
+    CHECK(report.p50 >= 500 && report.p50 <= 500 * 9 / 8);
+    CHECK(report.p99 >= 990 && report.p99 <= 990 * 9 / 8);
+    CHECK(report.p50 <= report.p90 && report.p90 <= report.p99 && report.p99 <= report.p999 && report.p999 <= report.p9999);
+    CHECK(manual.percentile(Latency::Op::RELEASE, Latency::Path::FAST, 0.5) == 0); // empty
+
+    // allocator records paths taken on calling thread
+    Alloc::latency().clear();
+    Alloc              alloc;
+    std::vector<void*> blocks;
+    for(int round = 0; round < 10; ++round) {
+        for(int i = 0; i < 5000; ++i) {
+            blocks.push_back(alloc.acquire());
+        }
+        for(void* ptr : blocks) {
+            alloc.release(ptr);
+        }
+        blocks.clear();
+        alloc.shrink();
+    }
+    const Latency& mine = Alloc::latency();
+    CHECK(mine.report(Latency::Op::ACQUIRE, Latency::Path::FAST).count > 0);
+    CHECK(mine.report(Latency::Op::ACQUIRE, Latency::Path::SYSCALL).count > 0);
+    CHECK(mine.report(Latency::Op::RELEASE, Latency::Path::FAST).count > 0);
+
+    uint64_t total = 0;
+    for(int path = 0; path < 4; ++path) {
+        total += mine.report(Latency::Op::ACQUIRE, Latency::Path(path)).count;
+    }
+    CHECK(total == 50000);
+
+    // per thread, merged
+    Latency merged;
+    merged.merge(mine);
+    std::thread([&] {
+        Alloc other;
+        other.release(other.acquire());
+        CHECK(Alloc::latency().report(Latency::Op::ACQUIRE, Latency::Path::SYSCALL).count == 1);
+        merged.merge(Alloc::latency());
+    }).join();
+    CHECK(merged.report(Latency::Op::ACQUIRE, Latency::Path::SYSCALL).count ==
+          mine.report(Latency::Op::ACQUIRE, Latency::Path::SYSCALL).count + 1);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <thread>
+#include <vector>
+
+static int alive = 0;
+
+struct Item {
+    long id;
+    Item(long in): id(in) { ++alive; }
+    ~Item() { --alive; }
+};
+
+struct List : Policy {
+    static constexpr Track TRACK = Track::LIST;
+};
+
+template<typename P> void run() {
+    Pool<Item, alignof(Item), 0, P> pool;
+    std::vector<Item*>              items;
+    for(long i = 0; i < 20000; ++i) {
+        items.push_back(pool.acquire(i));
+    }
+    for(size_t i = 0; i < items.size(); i += 3) {
+        pool.release(items[i]);
+    }
+    std::thread([&] { // remote frees are dropped before visit
+        for(size_t i = 1; i < items.size(); i += 3) {
+            Pagemap::release(items[i]);
+            --alive; // destructor is not called
+        }
+    }).join();
+
+    // every live object once, in address order
+    long        sum  = 0, expect = 0;
+    size_t      cnt  = 0;
+    const void* last = nullptr;
+    pool.for_each_live([&](Item* item) {
+        CHECK(!last || last < static_cast<const void*>(item));
+        last = item;
+        sum += item->id;
+        ++cnt;
+    });
+    for(size_t i = 2; i < items.size(); i += 3) {
+        expect += long(i);
+    }
+    CHECK(cnt == items.size() / 3 && sum == expect && alive == int(cnt));
+
+    // bulk destroy
+    pool.destroy_all();
+    CHECK(alive == 0);
+    cnt = 0;
+    pool.for_each_live([&](Item*) { ++cnt; });
+    CHECK(cnt == 0);
+
+    Item* reused = pool.acquire(5);
+    CHECK(reused && reused->id == 5);
+    pool.release(reused);
+}
+
+int main() {
+    run<Policy>();
+    run<List>();
+
+    // WHOLE
+    Allocator<size_t(2) << 20> whole;
+    void*                      first  = whole.acquire();
+    void*                      second = whole.acquire();
+    size_t                     cnt    = 0;
+    whole.for_each_live([&](void* ptr) {
+        CHECK(ptr == first || ptr == second);
+        ++cnt;
+    });
+    CHECK(cnt == 2);
+    whole.destroy_all();
+    CHECK(!whole.check(first) && !whole.check(second));
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "../mem/malloc.hpp"
+#include "check.hpp"
+#include <vector>
+
+template<typename A> void run(size_t count) {
+    A alloc;
+
+    // low: generated and prefaulted ahead
+    CHECK(alloc.maintain(4, 8) == 4);
+    CHECK(alloc.ready() == 4 * count);
+    CHECK(alloc.maintain(4, 8) == 0); // kept
+
+    // spare chunks are used first, then refilled
+    std::vector<void*> blocks;
+    for(size_t i = 0; i < 2 * count; ++i) {
+        blocks.push_back(alloc.acquire());
+    }
+    CHECK(alloc.ready() == 2 * count);
+    CHECK(alloc.maintain(4, 8) == 2);
+    CHECK(alloc.ready() == 4 * count);
+
+    // high: surplus destroyed
+    for(void* ptr : blocks) {
+        alloc.release(ptr);
+    }
+    CHECK(alloc.maintain(0, 3) == 3);
+    CHECK(alloc.ready() == 3 * count);
+    CHECK(alloc.maintain(0, 0) == 3);
+    CHECK(alloc.ready() == 0);
+}
+
+int main() {
+    run<Allocator<64>>(Allocator<64>::UNIT);
+    run<Allocator<size_t(2) << 20>>(1); // WHOLE
+
+    // every size class
+    Malloc& malloc = Malloc::local();
+    CHECK(malloc.maintain(1, 2) == SizeClass::COUNT);
+    CHECK(malloc.maintain(0, 0) == SizeClass::COUNT);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <set>
+#include <vector>
+
+struct Listed : Policy {
+    static constexpr Track TRACK = Track::LIST;
+};
+
+template<typename A> static void check() {
+    A                  alloc;
+    std::vector<void*> blocks;
+    std::set<void*>    live;
+    for(int i = 0; i < 60000; ++i) {
+        blocks.push_back(alloc.acquire());
+    }
+    // every second block is free
+    for(size_t i = 0; i < blocks.size(); i += 2) {
+        live.insert(blocks[i]);
+        alloc.release(blocks[i + 1]);
+    }
+
+    // same chunk as hint while it has free blocks, never a live block
+    size_t near = 0;
+    for(size_t i = 0; i < 1000; ++i) {
+        void* hint = blocks[i * 2];
+        void* ptr  = alloc.acquire_near(hint);
+        CHECK(ptr && alloc.check(ptr));
+        CHECK(live.insert(ptr).second);
+        near += (uintptr_t(ptr) ^ uintptr_t(hint)) < A::CHUNK;
+    }
+    CHECK(near > 900);
+
+    // nullptr and foreign hint fall back to acquire
+    int   foreign;
+    void* ptr = alloc.acquire_near(nullptr);
+    CHECK(ptr && live.insert(ptr).second);
+    ptr = alloc.acquire_near(&foreign);
+    CHECK(ptr && live.insert(ptr).second);
+
+    size_t count = 0;
+    alloc.for_each_live([&](void* curr) {
+        CHECK(live.count(curr));
+        ++count;
+    });
+    CHECK(count == live.size());
+    for(void* curr : live) {
+        alloc.release(curr);
+    }
+}
+
+int main() {
+    check<Allocator<48>>();
+    check<Allocator<48, Listed>>();
+
+    // nearest free block of bitmap tracking is adjacent
+    Pool<long> pool;
+    long*      first  = pool.acquire(1);
+    long*      second = pool.acquire(2);
+    pool.release(second);
+    long* third = pool.acquire_near(first, 3);
+    CHECK(third == second && *third == 3);
+    pool.release(first);
+    pool.release(third);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "../mem/malloc.hpp"
+#include "check.hpp"
+#include <thread>
+#include <vector>
+
+int main() {
+    Allocator<24>              small;
+    Allocator<100>             odd;
+    Allocator<size_t(3) << 20> whole;
+
+    std::vector<void*> blocks;
+    for(int i = 0; i < 50000; ++i) {
+        blocks.push_back(small.acquire());
+        blocks.push_back(odd.acquire());
+    }
+    std::vector<void*> huge;
+    for(int i = 0; i < 5; ++i) {
+        huge.push_back(whole.acquire());
+    }
+
+    // size and owner lookup
+    CHECK(Pagemap::size(blocks[0]) == 24 && Pagemap::size(blocks[1]) == Allocator<100>::BLOCK);
+    CHECK(Pagemap::size(static_cast<char*>(huge[2]) + 100000) == Allocator<size_t(3) << 20>::BLOCK);
+    CHECK(Pagemap::size(&blocks) == 0);
+    CHECK(Pagemap::find(blocks[0])->owner == &small);
+
+    // live block check
+    CHECK(Pagemap::check(blocks[0]) && Pagemap::check(blocks[1]) && Pagemap::check(huge[3]));
+    CHECK(!Pagemap::check(static_cast<char*>(blocks[0]) + 8)); // inside
+    CHECK(!Pagemap::check(&blocks));                           // not registered
+
+    // size-free release by owner thread and by other thread
+    for(size_t i = 0; i < blocks.size(); i += 2) {
+        CHECK(Pagemap::release(blocks[i]));
+    }
+    std::thread([&] {
+        for(size_t i = 1; i < blocks.size(); i += 2) {
+            CHECK(Pagemap::release(blocks[i])); // remote free
+        }
+    }).join();
+    CHECK(!Pagemap::check(blocks[0]));
+    CHECK(!Pagemap::release(&blocks));
+
+    // WHOLE
+    Pagemap::release(huge[1]);
+    whole.release(huge[0]);
+    CHECK(!whole.check(huge[1]) && whole.check(huge[2]));
+    whole.release(huge[2]);
+    whole.release(huge[3]);
+    whole.release(huge[4]);
+
+    // Malloc: usable size of size class and large
+    Malloc& heap  = Malloc::local();
+    void*   ptr   = heap.acquire(100);
+    void*   large = heap.acquire(1 << 20);
+    CHECK(Pagemap::size(ptr) >= 100 && Pagemap::size(large) >= 1 << 20);
+    heap.release(ptr);
+    heap.release(large);
+    CHECK(!Pagemap::find(large)); // unmapped
+
+    CHECK(small.shrink() > 0 && whole.shrink() > 0);
+    return 0;
+}
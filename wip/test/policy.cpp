@@ -0,0 +1,79 @@
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <vector>
+
+struct Hot : Policy {
+    static constexpr size_t  CHUNK   = 1 << 20;
+    static constexpr Track   TRACK   = Track::LIST;
+    static constexpr bool    STATS   = false;
+    static constexpr Thread  THREAD  = Thread::SINGLE;
+    static constexpr Backing BACKING = Backing::DIRECT;
+};
+
+struct Huge : Policy {
+    static constexpr size_t  CHUNK   = 1 << 22;
+    static constexpr Backing BACKING = Backing::HUGE;
+};
+
+struct Node {
+    long a[3];
+};
+
+// chunk size by policy, or by block size
+static_assert(Allocator<64, Hot>::CHUNK == Hot::CHUNK);
+static_assert(Allocator<100, Huge>::CHUNK == Huge::CHUNK);
+
+int main() {
+    // detected platform constants within compile time bounds
+    const size_t page = global::pal_page();
+    CHECK(global::bit_aligned(page) && page <= global::PAL_PAGE);
+    CHECK(global::pal_hugepage() == 0 || (global::bit_aligned(global::pal_hugepage()) && global::pal_hugepage() > page));
+    CHECK(global::bit_aligned(global::pal_cacheline()) && global::pal_cacheline() >= 16);
+    CHECK(global::pal_page() == page); // cached
+
+    // tuned policy: chunk size, list tracking, direct backing
+    Cache::trim();
+    {
+        Allocator<64, Hot> hot;
+        std::vector<void*> blocks;
+        for(int i = 0; i < 100000; ++i) {
+            void* ptr = hot.acquire();
+            CHECK(ptr && hot.check(ptr));
+            blocks.push_back(ptr);
+        }
+        size_t live = 0;
+        hot.for_each_live([&](void*) { ++live; });
+        CHECK(live == blocks.size());
+        for(void* ptr : blocks) {
+            hot.release(ptr);
+        }
+        hot.shrink();
+        CHECK(Cache::size() == 0);
+    }
+
+    // policy through pool
+    {
+        Pool<Node, alignof(Node), 4, Hot> pool;
+        auto                              handle = pool.acquire_handle();
+        CHECK(pool.resolve(handle) != nullptr);
+        pool.release(handle);
+        CHECK(pool.resolve(handle) == nullptr);
+    }
+
+    // huge backing is a hint only
+    {
+        Allocator<100, Huge> huge;
+        void*                ptr = huge.acquire();
+        CHECK(ptr && huge.check(ptr));
+        huge.release(ptr);
+    }
+
+    // default policy unchanged
+    {
+        Allocator<64> fallback;
+        void*         ptr = fallback.acquire();
+        CHECK(ptr && fallback.check(ptr));
+        fallback.release(ptr);
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "../mem/malloc.hpp"
+#include "check.hpp"
+#include <cstring>
+#include <vector>
+
+int main() {
+    Profiler::start(4096);
+    std::vector<void*> a, b;
+    for(int i = 0; i < 20000; ++i) {
+        a.push_back(Malloc::local().acquire(64)); // two sites
+        b.push_back(Malloc::local().acquire(1024));
+    }
+    CHECK(Profiler::live() > 0);
+
+    // pprof: unsampled totals near the real live bytes, header without rate
+    FILE* file = std::tmpfile();
+    CHECK(file && Profiler::dump(file));
+    std::rewind(file);
+    double live_cnt = 0, live_byte = 0, alloc_cnt = 0, alloc_byte = 0;
+    char   kind[16] = {};
+    CHECK(std::fscanf(file, "heap profile: %lf: %lf [%lf: %lf] @ %15s", &live_cnt, &live_byte, &alloc_cnt, &alloc_byte, kind) == 5);
+    CHECK(std::strcmp(kind, "heap") == 0);
+    const double real = 20000.0 * (64 + 1024);
+    CHECK(live_byte > real * 0.8 && live_byte < real * 1.2);
+    CHECK(live_cnt > 40000 * 0.7 && live_cnt < 40000 * 1.3);
+    std::fclose(file);
+
+    // folded: a stack per line, live bytes last
+    file = std::tmpfile();
+    CHECK(file && Profiler::dump(file, Profiler::Format::FOLDED));
+    std::rewind(file);
+    char   line[8192];
+    size_t lines = 0;
+    while(std::fgets(line, sizeof(line), file)) {
+        CHECK(std::strchr(line, ' ') && std::strtod(std::strrchr(line, ' ') + 1, nullptr) > 0);
+        ++lines;
+    }
+    CHECK(lines >= 2);
+    std::fclose(file);
+
+    // released blocks are forgotten
+    for(void* ptr : a) Malloc::local().release(ptr);
+    for(void* ptr : b) Malloc::local().release(ptr);
+    CHECK(Profiler::live() == 0);
+
+    // stopped: nothing sampled
+    Profiler::stop();
+    void* quiet = Malloc::local().acquire(1 << 20);
+    CHECK(Profiler::live() == 0);
+    Malloc::local().release(quiet);
+
+    // reset forgets samples of allocator
+    Profiler::start(64);
+    Allocator<64>      alloc;
+    std::vector<void*> blocks;
+    for(int i = 0; i < 5000; ++i) {
+        blocks.push_back(alloc.acquire());
+    }
+    CHECK(Profiler::live() > 0);
+    alloc.reset();
+    CHECK(Profiler::live() == 0);
+    Profiler::stop();
+    Profiler::clear();
+    return 0;
+}
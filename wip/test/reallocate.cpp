@@ -0,0 +1,41 @@
+#include "../mem/malloc.hpp"
+#include "check.hpp"
+#include <cstring>
+
+int main() {
+    Malloc& heap = Malloc::local();
+
+    // nullptr is acquire, 0 is release
+    char* buf = static_cast<char*>(heap.reallocate(nullptr, 100));
+    CHECK(buf && Pagemap::size(buf) >= 100);
+    for(int i = 0; i < 100; ++i) {
+        buf[i] = char(i);
+    }
+
+    // fits in size class, wastes less than half: same block
+    CHECK(heap.reallocate(buf, 90) == buf);
+
+    // grow through size classes into large blocks, contents kept
+    size_t byte = 100;
+    while(byte < (size_t(64) << 20)) {
+        const size_t next = byte * 3 / 2;
+        buf               = static_cast<char*>(heap.reallocate(buf, next));
+        CHECK(buf && Pagemap::size(buf) >= next);
+        for(int i = 0; i < 100; ++i) {
+            CHECK(buf[i] == char(i));
+        }
+        std::memset(buf + byte, 7, next - byte);
+        byte = next;
+    }
+    CHECK(buf[byte - 1] == 7);
+
+    // shrink large, then back into size class
+    buf = static_cast<char*>(heap.reallocate(buf, size_t(3) << 20));
+    CHECK(buf && Pagemap::size(buf) >= (size_t(3) << 20) && buf[99] == 99 && buf[(size_t(3) << 20) - 1] == 7);
+    buf = static_cast<char*>(heap.reallocate(buf, 1000));
+    CHECK(buf && Pagemap::size(buf) <= SizeClass::LARGE && buf[99] == 99);
+
+    CHECK(!heap.reallocate(buf, 0));
+    CHECK(!Pagemap::check(buf));
+    return 0;
+}
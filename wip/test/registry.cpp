@@ -0,0 +1,70 @@
+#include "../mem/allocator.hpp"
+#include "check.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using Small = Allocator<64>;
+using Page  = Allocator<4096>;
+using Whole = Allocator<size_t(2) << 20>;
+
+int main() {
+    Small small;
+    Page  page;
+    Whole whole;
+    small.maintain(3, 3);
+    page.maintain(5, 5);
+    whole.maintain(2, 2);
+
+    const size_t idle = 3 * Small::CHUNK + 5 * Page::CHUNK + 2 * Whole::CHUNK;
+    CHECK(Registry::idle() == idle);
+
+    // allocators of other threads are not counted, nor shrunk
+    std::thread([] {
+        Small other;
+        other.maintain(4, 4);
+        CHECK(Registry::idle() == 4 * Small::CHUNK);
+        CHECK(Registry::reclaim() >= 4 * Small::CHUNK && Registry::idle() == 0);
+    }).join();
+    CHECK(Registry::idle() == idle);
+
+    // biggest footprint first, until enough
+    CHECK(Registry::reclaim(Whole::CHUNK) >= Whole::CHUNK);
+    CHECK(Registry::idle() < idle && Registry::idle() > 0);
+
+    // pressure: release into idle chunk shrinks every allocator of this thread
+    std::vector<void*> blocks;
+    for(size_t i = 0; i < Small::UNIT * 2; ++i) {
+        blocks.push_back(small.acquire());
+    }
+    page.maintain(5, 5);
+    const uint32_t level = Registry::pressure();
+    Registry::signal();
+    CHECK(Registry::pressure() != level);
+    for(void* ptr : blocks) {
+        small.release(ptr);
+    }
+    CHECK(Registry::idle() <= Small::CHUNK); // page spares too, a chunk idled after the shrink is kept
+
+    Registry::reclaim();
+    CHECK(Registry::idle() == 0);
+
+    // maintain under pressure retires spare chunks, once per signal
+    page.maintain(5, 5); // pending signal
+    CHECK(Registry::idle() == 0);
+    page.maintain(5, 5);
+    CHECK(Registry::idle() == 5 * Page::CHUNK);
+    Registry::signal();
+    page.maintain(5, 5);
+    CHECK(Registry::idle() == 0);
+
+    // watcher raises pressure while over threshold, skipped if not supported
+    if(Registry::watch(0, 10)) {
+        CHECK(!Registry::watch(0, 10)); // already
+        const uint32_t before = Registry::pressure();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Registry::unwatch();
+        CHECK(Registry::pressure() != before);
+    }
+    return 0;
+}
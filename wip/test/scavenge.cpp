@@ -0,0 +1,92 @@
+#include "../mem/malloc.hpp"
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <cstring>
+#include <vector>
+
+struct Listed : Policy {
+    static constexpr Track TRACK  = Track::LIST;
+    static constexpr bool  HARDEN = true;
+};
+
+struct Bitmap : Policy {
+    static constexpr Track TRACK = Track::BITMAP;
+};
+
+template<typename P> static void check() {
+    Allocator<64, P>   alloc;
+    std::vector<void*> blocks;
+    std::vector<void*> kept;
+    for(int i = 0; i < 200000; ++i) {
+        void* ptr = alloc.acquire();
+        std::memset(ptr, 0xAB, 64);
+        blocks.push_back(ptr);
+    }
+    // one live block per 256
+    for(size_t i = 0; i < blocks.size(); ++i) {
+        if(i % 256 == 0) {
+            kept.push_back(blocks[i]);
+        }
+        else alloc.release(blocks[i]);
+    }
+    blocks.clear();
+
+    // budget is checked per run of pages, then nothing left to discard
+    CHECK(alloc.scavenge(1) > 0);
+    CHECK(alloc.scavenge() > 0);
+    CHECK(alloc.scavenge() == 0);
+    for(void* ptr : kept) {
+        CHECK(alloc.check(ptr) && *static_cast<unsigned char*>(ptr) == 0xAB);
+    }
+
+    // discarded blocks are refaulted on reuse, live blocks untouched
+    for(int i = 0; i < 200000; ++i) {
+        void* ptr = alloc.acquire();
+        CHECK(ptr);
+        std::memset(ptr, 0xCD, 64);
+        blocks.push_back(ptr);
+    }
+    for(void* ptr : kept) {
+        CHECK(*static_cast<unsigned char*>(ptr) == 0xAB);
+    }
+    for(void* ptr : blocks) {
+        alloc.release(ptr);
+    }
+    blocks.clear();
+
+    // lazy discard
+    CHECK(alloc.scavenge(~size_t(0), true) > 0);
+    for(int i = 0; i < 50000; ++i) {
+        void* ptr = alloc.acquire();
+        std::memset(ptr, 1, 64);
+        blocks.push_back(ptr);
+    }
+    for(void* ptr : blocks) {
+        alloc.release(ptr);
+    }
+    for(void* ptr : kept) {
+        alloc.release(ptr);
+    }
+}
+
+int main() {
+    check<Listed>();
+    check<Bitmap>();
+
+    // malloc scavenges its size classes
+    Malloc&            malloc = Malloc::local();
+    std::vector<void*> blocks;
+    for(int i = 0; i < 100000; ++i) {
+        blocks.push_back(malloc.acquire(48));
+    }
+    for(size_t i = 0; i < blocks.size(); ++i) {
+        if(i % 200) {
+            malloc.release(blocks[i]);
+        }
+    }
+    CHECK(malloc.scavenge() > 0);
+    for(size_t i = 0; i < blocks.size(); i += 200) {
+        malloc.release(blocks[i]);
+    }
+    return 0;
+}
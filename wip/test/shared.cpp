@@ -0,0 +1,67 @@
+#include "../mem/shared.hpp"
+#include "check.hpp"
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct Queue {
+    static constexpr size_t SIZE = 1000;
+
+    std::atomic<uint64_t> cnt{ 0 };
+    uint64_t              msg[SIZE];
+};
+
+int main() {
+    const std::string name = "/shared_test_" + std::to_string(getpid());
+
+    Heap* heap = Heap::share(name.c_str(), 64 << 20);
+    CHECK(heap);
+    Shared<64>* alloc = heap->root<Shared<64>>(0, heap);
+    Queue*      queue = heap->root<Queue>(1);
+    CHECK(alloc && queue);
+
+    // producer in child process, attached at its own base
+    const pid_t pid = fork();
+    CHECK(pid >= 0);
+    if(pid == 0) {
+        Heap*       mine = Heap::share(name.c_str(), 64 << 20);
+        Shared<64>* from = mine ? mine->root<Shared<64>>(0, mine) : nullptr;
+        Queue*      to   = mine ? mine->root<Queue>(1) : nullptr;
+        if(!from || !to) {
+            _exit(1);
+        }
+        for(uint64_t i = 0; i < Queue::SIZE; ++i) {
+            uint64_t* ptr = from->acquire<uint64_t>(i * 3);
+            if(!ptr) {
+                _exit(1);
+            }
+            to->msg[i] = mine->offset(ptr); // offset only
+            to->cnt.store(i + 1, std::memory_order_release);
+        }
+        Heap::close(mine);
+        _exit(0);
+    }
+
+    int status = 0;
+    CHECK(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    // consumer
+    CHECK(queue->cnt.load(std::memory_order_acquire) == Queue::SIZE);
+    for(uint64_t i = 0; i < Queue::SIZE; ++i) {
+        uint64_t* ptr = heap->resolve<uint64_t>(queue->msg[i]);
+        CHECK(ptr && *ptr == i * 3);
+        alloc->release(ptr);
+    }
+    CHECK(!heap->resolve(0));
+
+    // released blocks are reused by this process
+    const size_t remain = heap->remain();
+    void*        ptr    = alloc->acquire();
+    CHECK(ptr && heap->remain() == remain);
+    alloc->release(ptr);
+
+    Heap::close(heap);
+    shm_unlink(name.c_str());
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "../mem/malloc.hpp"
+#include "../mem/pool.hpp"
+#include "check.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct Shared : Policy {
+    static constexpr Thread THREAD = Thread::SHARED;
+};
+
+struct Node {
+    int a[10];
+
+    Node(int in) {
+        a[0] = in;
+    }
+};
+
+int main() {
+    // malloc: charged by size class block, rejected over budget
+    Malloc&            malloc = Malloc::local();
+    Tag                small(1000);
+    std::vector<void*> blocks;
+    while(void* ptr = malloc.acquire(100, small)) {
+        blocks.push_back(ptr);
+    }
+    CHECK(!blocks.empty() && small.used() <= small.budget() && small.rejected() == 1);
+    for(void* ptr : blocks) {
+        malloc.release(ptr, small);
+    }
+    blocks.clear();
+    CHECK(small.used() == 0);
+
+    // malloc: large mapping
+    Tag   large(1 << 20);
+    void* ptr = malloc.acquire(300000, large);
+    CHECK(ptr && large.used() >= 300000);
+    CHECK(!malloc.acquire(900000, large));
+    malloc.release(ptr, large);
+    CHECK(large.used() == 0);
+
+    // bound pool: every acquire path is charged, refunded on release and destruction
+    Tag bound(Pool<Node>::BLOCK * 3);
+    {
+        Pool<Node> pool;
+        pool.bind(&bound);
+        Node* first  = pool.acquire(1);
+        Node* second = pool.acquire(2);
+        Node* third  = pool.acquire(3);
+        CHECK(third && bound.used() == Pool<Node>::BLOCK * 3);
+        CHECK(!pool.acquire(4) && !pool.acquire_near(first, 5) && !pool.acquire_aligned(64, 6));
+        pool.release(first);
+        Node* batch[2] = { second, third };
+        pool.release(batch, 2);
+        CHECK(bound.used() == 0);
+        CHECK(pool.acquire(1)); // live at destruction
+    }
+    CHECK(bound.used() == 0);
+
+    // remote frees refunded when drained by owner
+    Tag remote;
+    {
+        Allocator<64> alloc;
+        alloc.bind(&remote);
+        for(int i = 0; i < 5000; ++i) {
+            blocks.push_back(alloc.acquire());
+        }
+        std::thread([&] {
+            for(void* curr : blocks) {
+                Malloc::local().release(curr);
+            }
+        }).join();
+        for(int i = 0; i < 5000; ++i) {
+            blocks[i] = alloc.acquire();
+        }
+        CHECK(remote.used() == 5000 * 64);
+        for(void* curr : blocks) {
+            alloc.release(curr);
+        }
+        blocks.clear();
+    }
+    CHECK(remote.used() == 0);
+
+    // shared allocator from many threads never grants over budget, used() may overshoot while a charge is undone
+    Tag many(64 * 100);
+    {
+        Allocator<64, Shared>    alloc;
+        std::vector<std::thread> threads;
+        std::atomic<size_t>      held{ 0 };
+        alloc.bind(&many);
+        for(int i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                std::vector<void*> local;
+                for(int k = 0; k < 10000; ++k) {
+                    if(void* curr = alloc.acquire()) {
+                        local.push_back(curr);
+                        CHECK(++held * 64 <= many.budget());
+                        continue;
+                    }
+                    // rejected: give back
+                    for(void* curr : local) {
+                        --held;
+                        alloc.release(curr);
+                    }
+                    local.clear();
+                }
+                for(void* curr : local) {
+                    --held;
+                    alloc.release(curr);
+                }
+            });
+        }
+        for(std::thread& thread : threads) {
+            thread.join();
+        }
+        CHECK(many.rejected() > 0);
+    }
+    CHECK(many.used() == 0);
+    return 0;
+}
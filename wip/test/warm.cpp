@@ -0,0 +1,59 @@
+#include "../mem/allocator.hpp"
+#include "check.hpp"
+#include <cstring>
+
+//! @brief locked KiB of process, -1 if unknown
+static long locked() {
+    FILE* file = std::fopen("/proc/self/status", "r");
+    if(!file) {
+        return -1;
+    }
+    char line[256];
+    long kib = -1;
+    while(std::fgets(line, sizeof(line), file)) {
+        if(std::strncmp(line, "VmLck:", 6) == 0) {
+            kib = std::atol(line + 6);
+        }
+    }
+    std::fclose(file);
+    return kib;
+}
+
+template<typename A> void run(size_t reserve) {
+    A alloc;
+    CHECK(alloc.ready() == 0); // lazy by default
+
+    // prefault reserved chunks
+    CHECK(alloc.warm(A::Warm::PREFAULT));
+    alloc.reserve(reserve);
+    const size_t ready = alloc.ready();
+    CHECK(ready >= reserve);
+
+    void* ptr = alloc.acquire();
+    CHECK(ptr && alloc.ready() == ready - 1);
+    std::memset(ptr, 1, 64);
+    alloc.release(ptr);
+    CHECK(alloc.ready() == ready);
+
+    // lazy: populated pages stay, new chunks fault on touch
+    CHECK(alloc.warm(A::Warm::LAZY));
+    CHECK(alloc.ready() <= ready);
+
+    // lock, then unlock by leaving LOCK, skipped without mlock privilege
+    const long base = locked();
+    if(alloc.warm(A::Warm::LOCK)) {
+        CHECK(alloc.ready() >= reserve);
+        const long on = locked();
+        CHECK(alloc.warm(A::Warm::PREFAULT));
+        if(on > base) {
+            CHECK(locked() == base);
+        }
+    }
+    alloc.warm(A::Warm::LAZY);
+}
+
+int main() {
+    run<Allocator<64>>(1000);
+    run<Allocator<size_t(2) << 20>>(4); // WHOLE
+    return 0;
+}